@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_fft_autotest.c
+//
+// Test 64-point transform backends against direct DFT, and shared plan
+// cache
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+// run test with a specific backend, direction and options, returning
+// the number of output samples in error
+unsigned int wlan_fft_runtest(int _backend,
+                              int _direction,
+                              int _flags)
+{
+    if (wlan_fft_set_backend(_backend) != 0) {
+        printf("  backend %d unavailable; skipping\n", _backend);
+        return 0;
+    }
+
+    float complex x[64];
+    float complex y[64];
+    float complex y_test[64];
+    wlan_fft q = wlan_fft_create(x, y, _direction, _flags);
+
+    // random input, with NULL subcarriers zeroed if requested
+    unsigned int i;
+    unsigned int k;
+    for (i=0; i<64; i++) {
+        x[i] = ((rand() % 2001) - 1000)*1e-3f + ((rand() % 2001) - 1000)*1e-3f*_Complex_I;
+        if ((_flags & WLAN_FFT_FLAG_NULLS) && (i == 0 || (i>26 && i<38)))
+            x[i] = 0.0f;
+    }
+
+    // direct transform
+    for (k=0; k<64; k++) {
+        y_test[k] = 0.0f;
+        for (i=0; i<64; i++)
+            y_test[k] += x[i] * cexpf(_direction*_Complex_I*2*M_PI*i*k/64.0f);
+    }
+
+    // run transform on bound arrays, then in place on new array
+    wlan_fft_execute(q);
+    float complex z[64];
+    memmove(z, x, sizeof(z));
+    wlan_fft_execute_dft(q, z, z);
+    wlan_fft_destroy(q);
+
+    unsigned int num_errors = 0;
+    for (k=0; k<64; k++) {
+        num_errors += cabsf(y[k] - y_test[k]) < 1e-3f ? 0 : 1;
+        num_errors += cabsf(z[k] - y_test[k]) < 1e-3f ? 0 : 1;
+    }
+    printf("  backend %d, direction %2d, flags %d : errors : %3u / 128\n",
+            _backend, _direction, _flags, num_errors);
+
+    return num_errors;
+}
+
+// create and run transform objects concurrently
+void * wlan_fft_thread(void * _arg)
+{
+    float complex x[64];
+    float complex y[64];
+    unsigned int i;
+    unsigned int n;
+    for (n=0; n<100; n++) {
+        for (i=0; i<64; i++)
+            x[i] = i == n % 64 ? 1.0f : 0.0f;
+        wlan_fft q = wlan_fft_create(x, y, WLAN_FFT_FORWARD, 0);
+        wlan_fft_execute(q);
+        wlan_fft_destroy(q);
+
+        // impulse at n: |y[k]| = 1 for all k
+        for (i=0; i<64; i++) {
+            if (fabsf(cabsf(y[i]) - 1.0f) > 1e-4f)
+                *(unsigned int*)_arg += 1;
+        }
+    }
+    return NULL;
+}
+
+// test shared plan cache: planner effort, wisdom persistence, lifetime
+// and concurrent object creation
+unsigned int wlan_fft_cache_runtest(int _backend)
+{
+    if (wlan_fft_set_backend(_backend) != 0)
+        return 0;
+
+    unsigned int num_errors = 0;
+    char filename[] = "/tmp/wlan_fft_autotest.wisdom";
+    unlink(filename);
+
+    // measured plans are exported to wisdom file (fftw only)
+    wlan_fft_set_wisdom_file(filename);
+    wlan_fft_set_planner(WLAN_FFT_PLANNER_MEASURE);
+    num_errors += wlan_fft_runtest(_backend, WLAN_FFT_FORWARD, 0);
+    if (_backend == WLAN_FFT_BACKEND_FFTW && access(filename, F_OK) != 0) {
+        printf("  wisdom file not written\n");
+        num_errors++;
+    }
+    wlan_fft_set_planner(WLAN_FFT_PLANNER_ESTIMATE);
+    wlan_fft_set_wisdom_file(NULL);
+    unlink(filename);
+
+    // cache may only be cleared once no object uses it (liquid-dsp plans
+    // are bound to their arrays and not cached)
+    float complex x[64];
+    wlan_fft q = wlan_fft_create(x, x, WLAN_FFT_FORWARD, 0);
+    num_errors += wlan_fft_cache_clear() == (_backend != WLAN_FFT_BACKEND_LIQUID) ? 0 : 1;
+    wlan_fft_destroy(q);
+    num_errors += wlan_fft_cache_clear() == 0 ? 0 : 1;
+
+    // concurrent creation
+    pthread_t threads[4];
+    unsigned int thread_errors[4] = {0,0,0,0};
+    unsigned int i;
+    for (i=0; i<4; i++)
+        pthread_create(&threads[i], NULL, wlan_fft_thread, &thread_errors[i]);
+    for (i=0; i<4; i++) {
+        pthread_join(threads[i], NULL);
+        num_errors += thread_errors[i];
+    }
+    printf("  backend %d, plan cache : errors : %3u\n", _backend, num_errors);
+
+    return num_errors;
+}
+
+int main() {
+    int backends[3] = {WLAN_FFT_BACKEND_LIQUID,
+                       WLAN_FFT_BACKEND_FFTW,
+                       WLAN_FFT_BACKEND_BUILTIN};
+    int backend_default = wlan_fft_get_backend();
+
+    unsigned int i;
+    unsigned int num_errors = 0;
+    for (i=0; i<3; i++) {
+        num_errors += wlan_fft_runtest(backends[i], WLAN_FFT_FORWARD,  0);
+        num_errors += wlan_fft_runtest(backends[i], WLAN_FFT_BACKWARD, 0);
+        num_errors += wlan_fft_runtest(backends[i], WLAN_FFT_BACKWARD, WLAN_FFT_FLAG_NULLS);
+        num_errors += wlan_fft_cache_runtest(backends[i]);
+    }
+    wlan_fft_set_backend(backend_default);
+
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, transform mismatch\n", __FILE__);
+        exit(1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_iqsource_autotest.c
+//
+// Test IQ recording source: samples written in each format must be read
+// back scaled, SigMF metadata must set the format and sample rate, and a
+// frame recorded as ci16 must be decoded from the recording
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "liquid-wlan.h"
+
+#define NUM_SAMPLES     (1000)  // not a multiple of the conversion group
+
+// callback function
+static int callback(int                    _header_valid,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    int * num_frames = (int*) _userdata;
+    unsigned int i;
+    int valid = _header_valid && _rxvector.LENGTH == 100;
+    for (i=0; valid && i<100; i++)
+        valid = _payload[i] == i;
+    if (valid)
+        (*num_frames)++;
+    return 0;
+}
+
+// write recording of test pattern, returning reference samples
+//  _filename   :   file name
+//  _format     :   sample format
+//  _x          :   reference samples [size: NUM_SAMPLES x 1]
+void wlan_iqsource_write(const char *    _filename,
+                         int             _format,
+                         float complex * _x)
+{
+    FILE * fid = fopen(_filename, "w");
+    unsigned int i;
+    for (i=0; i<NUM_SAMPLES; i++) {
+        int vi = (int)(i % 255) - 127;
+        int vq = 127 - (int)((3*i) % 255);
+        if (_format == WLAN_IQ_CF32) {
+            float v[2] = {0.01f*vi, -0.02f*vq};
+            fwrite(v, sizeof(float), 2, fid);
+            _x[i] = v[0] + _Complex_I*v[1];
+        } else if (_format == WLAN_IQ_CI16) {
+            int16_t v[2] = {vi*256, vq*256};
+            fwrite(v, sizeof(int16_t), 2, fid);
+            _x[i] = (vi + _Complex_I*vq) / 128.0f;
+        } else {
+            int8_t v[2] = {vi, vq};
+            fwrite(v, sizeof(int8_t), 2, fid);
+            _x[i] = (vi + _Complex_I*vq) / 128.0f;
+        }
+    }
+    // trailing partial sample is ignored
+    fputc(0x55, fid);
+    fclose(fid);
+}
+
+// read back recording in uneven blocks and compare to reference
+int wlan_iqsource_runtest(const char *    _filename,
+                          int             _format,
+                          float complex * _x)
+{
+    wlan_iqsource q = wlan_iqsource_create(_filename, _format);
+    float complex y[NUM_SAMPLES];
+    unsigned int n = 0;
+    unsigned int k = 1;
+    while (n < NUM_SAMPLES) {
+        unsigned int m = wlan_iqsource_read(q, &y[n], k);
+        if (m == 0) break;
+        n += m;
+        k += 37;
+    }
+
+    int valid = n == NUM_SAMPLES && wlan_iqsource_get_num_samples(q) == NUM_SAMPLES &&
+                wlan_iqsource_get_num_remaining(q) == 0;
+    unsigned int i;
+    for (i=0; valid && i<NUM_SAMPLES; i++)
+        valid = cabsf(y[i] - _x[i]) < 1e-6f;
+    if (!valid)
+        fprintf(stderr,"wlan_iqsource_autotest: format %d, %u samples read, mismatch at %u\n", _format, n, i-1);
+
+    wlan_iqsource_destroy(q);
+    return valid;
+}
+
+int main() {
+    char base[] = "/tmp/wlan_iqsource_autotestXXXXXX";
+    int fd = mkstemp(base);
+    if (fd < 0) {
+        fprintf(stderr,"fail: %s, could not create temporary file\n", __FILE__);
+        exit(1);
+    }
+    close(fd);
+    char filename_meta[sizeof(base) + 11];
+    char filename_data[sizeof(base) + 11];
+    sprintf(filename_meta, "%s.sigmf-meta", base);
+    sprintf(filename_data, "%s.sigmf-data", base);
+
+    // raw recordings in each format
+    int valid = 1;
+    float complex x[NUM_SAMPLES];
+    int format;
+    for (format=WLAN_IQ_CF32; format<=WLAN_IQ_CI8; format++) {
+        wlan_iqsource_write(base, format, x);
+        valid &= wlan_iqsource_runtest(base, format, x);
+    }
+
+    // SigMF recording
+    wlan_iqsource_write(filename_data, WLAN_IQ_CI16, x);
+    FILE * fid = fopen(filename_meta, "w");
+    fprintf(fid, "{\n");
+    fprintf(fid, "    \"global\": {\n");
+    fprintf(fid, "        \"core:datatype\": \"ci16_le\",\n");
+    fprintf(fid, "        \"core:sample_rate\": 20000000,\n");
+    fprintf(fid, "        \"core:version\": \"1.0.0\"\n");
+    fprintf(fid, "    },\n");
+    fprintf(fid, "    \"captures\": [],\n");
+    fprintf(fid, "    \"annotations\": []\n");
+    fprintf(fid, "}\n");
+    fclose(fid);
+
+    wlan_iqsource q = wlan_iqsource_create_sigmf(filename_meta);
+    float complex y[NUM_SAMPLES];
+    unsigned int n = wlan_iqsource_read(q, y, NUM_SAMPLES);
+    wlan_iqsource_print(q);
+    if (wlan_iqsource_get_sample_rate(q) != 20e6f || n != NUM_SAMPLES || cabsf(y[NUM_SAMPLES-1] - x[NUM_SAMPLES-1]) > 1e-6f) {
+        fprintf(stderr,"wlan_iqsource_autotest: SigMF recording not read properly\n");
+        valid = 0;
+    }
+    wlan_iqsource_destroy(q);
+
+    // frame recorded as ci16, decoded from the recording in one pass
+    unsigned char payload[100];
+    unsigned int i;
+    for (i=0; i<100; i++)
+        payload[i] = i;
+    struct wlan_txvector_s txvector = {100, WLANFRAME_RATE_24, 0, 0};
+    wlanframegen fg = wlanframegen_create();
+    wlanframegen_assemble(fg, payload, txvector);
+    float complex frame[4000];
+    unsigned int frame_len = wlanframegen_write_samples(fg, frame, 4000);
+    wlanframegen_destroy(fg);
+
+    fid = fopen(base, "w");
+    for (i=0; i<WLANFRAME_DIFS + frame_len + WLANFRAME_DIFS; i++) {
+        float complex v = (i >= WLANFRAME_DIFS && i < WLANFRAME_DIFS + frame_len) ? frame[i-WLANFRAME_DIFS] : 0;
+        int16_t s[2] = {(int16_t)lrintf(8192*crealf(v)), (int16_t)lrintf(8192*cimagf(v))};
+        fwrite(s, sizeof(int16_t), 2, fid);
+    }
+    fclose(fid);
+
+    int num_frames = 0;
+    wlanframesync fs = wlanframesync_create(callback, &num_frames);
+    q = wlan_iqsource_create(base, WLAN_IQ_CI16);
+    unsigned long int num_samples = wlan_iqsource_execute(q, fs, -1UL);
+    if (num_frames != 1 || num_samples != WLANFRAME_DIFS + frame_len + WLANFRAME_DIFS) {
+        fprintf(stderr,"wlan_iqsource_autotest: decoded %d frames from %lu samples\n", num_frames, num_samples);
+        valid = 0;
+    }
+    wlan_iqsource_destroy(q);
+    wlanframesync_destroy(fs);
+
+    unlink(base);
+    unlink(filename_meta);
+    unlink(filename_data);
+
+    if (!valid) {
+        fprintf(stderr,"fail: %s, IQ source failure\n", __FILE__);
+        exit(1);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_packet_codec_autotest.c
+//
+// Test packet encoder/decoder loopback (scrambling, convolutional coding,
+// puncturing, interleaving) at every rate and data length 1..300
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// run loopback test with a specific rate and length, returning the number
+// of payload bytes in error
+unsigned int wlan_packet_codec_runtest(unsigned int _rate,
+                                       unsigned int _length)
+{
+    unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(_rate, _length);
+
+    unsigned char msg_org[_length];     // original message
+    unsigned char msg_enc[enc_msg_len]; // encoded message
+    unsigned char msg_dec[_length];     // decoded message
+
+    unsigned int i;
+    for (i=0; i<_length; i++)
+        msg_org[i] = rand() & 0xff;
+
+    // scrambler seed (nonzero, 7 bits)
+    unsigned int seed = 1 + (rand() % 127);
+
+    // encode/decode
+    wlan_packet_encode(_rate, seed, _length, msg_org, msg_enc);
+    wlan_packet_decode(_rate, seed, _length, msg_enc, msg_dec);
+
+    // count errors
+    unsigned int num_errors = 0;
+    for (i=0; i<_length; i++)
+        num_errors += msg_dec[i] == msg_org[i] ? 0 : 1;
+
+    return num_errors;
+}
+
+int main() {
+    srand(0);
+
+    unsigned int rate;
+    unsigned int length;
+    unsigned int num_failures = 0;
+    for (rate=0; rate<8; rate++) {
+        for (length=1; length<=300; length++) {
+            unsigned int num_errors = wlan_packet_codec_runtest(rate, length);
+            if (num_errors > 0) {
+                printf("  rate %u, length %3u : %u byte error(s)\n", rate, length, num_errors);
+                num_failures++;
+            }
+        }
+    }
+
+    if (num_failures > 0) {
+        fprintf(stderr,"fail: %s, %u packet(s) decoded with errors\n", __FILE__, num_failures);
+        exit(1);
+    }
+
+    printf("done.\n");
+    return 0;
+}
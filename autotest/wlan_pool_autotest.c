@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_pool_autotest.c
+//
+// Test placement of frame generators/synchronizers in an object memory
+// pool against heap-allocated objects, and pool exhaustion/re-use
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+#include "wlanframegen_reference.c"
+
+// number of pooled objects: one generator, three synchronizers
+#define NUM_BLOCKS      (4)
+
+// maximum number of frame samples
+#define NUM_SAMPLES_MAX (8000)
+
+// callback: count frames decoded without errors
+static int callback(int                    _header_valid,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    unsigned int * num_valid = (unsigned int*) _userdata;
+    if (_header_valid && _rxvector.LENGTH == 100 &&
+        memcmp(_payload, annexg_G1, _rxvector.LENGTH) == 0)
+    {
+        (*num_valid)++;
+    }
+    return 0;
+}
+
+int main() {
+    struct wlan_txvector_s txvector = {100, WLANFRAME_RATE_36, 0, 0};
+    unsigned int i;
+    int valid = 1;
+
+    // create pool holding either object type
+    size_t block_size = wlanframesync_sizeof() > wlanframegen_sizeof() ?
+                        wlanframesync_sizeof() : wlanframegen_sizeof();
+    wlan_pool pool = wlan_pool_create(block_size, NUM_BLOCKS);
+
+    // allocate all blocks; must be aligned and the pool then exhausted
+    void * blocks[NUM_BLOCKS];
+    for (i=0; i<NUM_BLOCKS; i++) {
+        blocks[i] = wlan_pool_alloc(pool);
+        if (blocks[i] == NULL || (uintptr_t)blocks[i] % WLAN_MEMORY_ALIGN) {
+            fprintf(stderr,"wlan_pool_autotest: invalid block %u\n", i);
+            valid = 0;
+        }
+    }
+    if (wlan_pool_alloc(pool) != NULL || wlan_pool_get_num_free(pool) != 0) {
+        fprintf(stderr,"wlan_pool_autotest: pool not exhausted\n");
+        valid = 0;
+    }
+
+    // reference frame from heap-allocated generator
+    float complex frame_ref[NUM_SAMPLES_MAX];
+    wlanframegen fg_ref = wlanframegen_create();
+    unsigned int num_samples = wlanframegen_reference(fg_ref, annexg_G1, txvector, frame_ref, NUM_SAMPLES_MAX);
+    wlanframegen_destroy(fg_ref);
+
+    // pooled generator must produce identical samples
+    float complex frame[NUM_SAMPLES_MAX];
+    wlanframegen fg = wlanframegen_init(blocks[0]);
+    if (wlanframegen_reference(fg, annexg_G1, txvector, frame, NUM_SAMPLES_MAX) != num_samples ||
+        memcmp(frame, frame_ref, num_samples*sizeof(float complex)) != 0)
+    {
+        fprintf(stderr,"wlan_pool_autotest: pooled generator output mismatch\n");
+        valid = 0;
+    }
+    wlanframegen_fini(fg);
+    wlan_pool_free(pool, blocks[0]);
+
+    // pooled synchronizers must each decode the frame; the first is
+    // finalized and re-initialized in a block returned to the pool
+    unsigned int num_valid[NUM_BLOCKS] = {0};
+    wlanframesync fs[NUM_BLOCKS];
+    for (i=1; i<NUM_BLOCKS; i++)
+        fs[i] = wlanframesync_init(blocks[i], callback, &num_valid[i]);
+    for (i=1; i<NUM_BLOCKS; i++)
+        wlanframesync_execute(fs[i], frame, num_samples);
+
+    wlanframesync_fini(fs[1]);
+    wlan_pool_free(pool, blocks[1]);
+    void * block = wlan_pool_alloc(pool);
+    fs[1] = wlanframesync_init(block, callback, &num_valid[0]);
+    wlanframesync_execute(fs[1], frame, num_samples);
+
+    for (i=0; i<NUM_BLOCKS; i++) {
+        if (num_valid[i] != 1) {
+            fprintf(stderr,"wlan_pool_autotest: synchronizer %u decoded %u frames\n", i, num_valid[i]);
+            valid = 0;
+        }
+    }
+
+    // release objects; all blocks but one must be free
+    wlanframesync_fini(fs[1]);
+    wlan_pool_free(pool, block);
+    for (i=2; i<NUM_BLOCKS; i++) {
+        wlanframesync_fini(fs[i]);
+        wlan_pool_free(pool, blocks[i]);
+    }
+    if (wlan_pool_get_num_free(pool) != NUM_BLOCKS) {
+        fprintf(stderr,"wlan_pool_autotest: blocks not returned to pool\n");
+        valid = 0;
+    }
+    wlan_pool_print(pool);
+    wlan_pool_destroy(pool);
+
+    if (!valid) {
+        fprintf(stderr,"fail: %s, pooled object failure\n", __FILE__);
+        exit(1);
+    }
+
+    return 0;
+}
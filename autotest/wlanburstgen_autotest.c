@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanburstgen_autotest.c
+//
+// Test burst generation (frames plus inter-frame gaps) through a small
+// ring buffer against frames generated individually
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+#include "wlanframegen_reference.c"
+
+// maximum number of reference samples
+#define NUM_SAMPLES_MAX (8000)
+
+int main() {
+    // options
+    unsigned char * msg_org = annexg_G1;
+    struct wlan_txvector_s txvector_a = {100, WLANFRAME_RATE_36, 0, 0};
+    struct wlan_txvector_s txvector_b = { 37, WLANFRAME_RATE_12, 0, 0};
+    unsigned int gap_a = WLANFRAME_SIFS;
+    unsigned int gap_b = 100;
+
+    // reference: frame a, gap, frame b, gap
+    float complex burst_ref[2*NUM_SAMPLES_MAX];
+    wlanframegen fg_ref = wlanframegen_create();
+    unsigned int n = 0;
+    n += wlanframegen_reference(fg_ref, msg_org, txvector_a, &burst_ref[n], 2*NUM_SAMPLES_MAX - n);
+    memset(&burst_ref[n], 0x00, gap_a*sizeof(float complex));
+    n += gap_a;
+    n += wlanframegen_reference(fg_ref, msg_org, txvector_b, &burst_ref[n], 2*NUM_SAMPLES_MAX - n);
+    memset(&burst_ref[n], 0x00, gap_b*sizeof(float complex));
+    n += gap_b;
+    wlanframegen_destroy(fg_ref);
+    unsigned int num_samples = n;
+
+    // create burst generator with small ring buffer to force wrapping;
+    // a frame at the unsupported 9 M bits/s rate must not be scheduled
+    struct wlan_txvector_s txvector_9 = {100, WLANFRAME_RATE_9, 0, 0};
+    wlanburstgen q = wlanburstgen_create(4, 500);
+    if (wlanburstgen_push(q, msg_org, txvector_a, gap_a) !=  0 ||
+        wlanburstgen_push(q, msg_org, txvector_9, gap_a) != -1 ||
+        wlanburstgen_push(q, msg_org, txvector_b, gap_b) !=  0)
+    {
+        fprintf(stderr,"fail: %s, unexpected schedule result\n", __FILE__);
+        exit(1);
+    }
+
+    // alternate between producer and consumer with irregular reads
+    float complex burst[2*NUM_SAMPLES_MAX];
+    unsigned int read_len[4] = {77, 512, 3, 260};
+    unsigned int i = 0;
+    n = 0;
+    while (n < num_samples) {
+        wlanburstgen_execute(q);
+        unsigned int k = wlanburstgen_read(q, &burst[n], read_len[i++ % 4]);
+        if (k == 0) break;
+        n += k;
+    }
+    unsigned long int num_frames = wlanburstgen_get_num_frames(q);
+    unsigned int num_remaining = wlanburstgen_execute(q) + wlanburstgen_get_num_available(q);
+    wlanburstgen_destroy(q);
+
+    // check results
+    unsigned int num_errors = 0;
+    for (i=0; i<num_samples; i++) {
+        if (cabsf(burst[i] - burst_ref[i]) > 1e-6f)
+            num_errors++;
+    }
+    printf("num samples       : %4u (expected %4u)\n", n, num_samples);
+    printf("num sample errors : %4u / %4u\n", num_errors, num_samples);
+    printf("num frames        : %4lu\n", num_frames);
+
+    if (n != num_samples || num_errors > 0 || num_frames != 2 || num_remaining != 0) {
+        fprintf(stderr,"fail: %s, failure\n", __FILE__);
+        exit(1);
+    }
+
+    printf("done.\n");
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapturesync_autotest.c
+//
+// Test capture decoding: a recording decoded in parallel chunks must
+// yield exactly the frames (and sample indices) of a serial decode
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <liquid/liquid.h>
+
+#include "liquid-wlan.h"
+
+#define MAX_LENGTH      (200)   // maximum payload length
+#define NUM_FRAMES      (60)    // frames in capture
+#define MAX_RESULTS     (2*NUM_FRAMES)
+
+// decoded frame list
+struct wlancapturesync_autotest_s {
+    wlanframesync fs;           // serial decoder (NULL if parallel)
+    unsigned int num_frames;
+    unsigned long int index[MAX_RESULTS];
+    int header_valid[MAX_RESULTS];
+    struct wlan_rxvector_s rxvector[MAX_RESULTS];
+    unsigned char payload[MAX_RESULTS][MAX_LENGTH];
+};
+
+// save frame to list
+static void save_frame(struct wlancapturesync_autotest_s * _r,
+                       unsigned long int                   _index,
+                       int                                 _header_valid,
+                       unsigned char *                     _payload,
+                       struct wlan_rxvector_s              _rxvector)
+{
+    if (_r->num_frames == MAX_RESULTS)
+        return;
+    unsigned int k = _r->num_frames++;
+    _r->index[k]        = _index;
+    _r->header_valid[k] = _header_valid;
+    _r->rxvector[k]     = _rxvector;
+    if (_header_valid)
+        memmove(_r->payload[k], _payload, _rxvector.LENGTH);
+}
+
+static int serial_callback(int                    _header_valid,
+                           unsigned char *        _payload,
+                           struct wlan_rxvector_s _rxvector,
+                           void *                 _userdata)
+{
+    struct wlancapturesync_autotest_s * r = (struct wlancapturesync_autotest_s*) _userdata;
+    save_frame(r, wlanframesync_get_num_samples(r->fs), _header_valid, _payload, _rxvector);
+    return 0;
+}
+
+static int parallel_callback(unsigned long int      _index,
+                             int                    _header_valid,
+                             unsigned char *        _payload,
+                             struct wlan_rxvector_s _rxvector,
+                             void *                 _userdata)
+{
+    save_frame((struct wlancapturesync_autotest_s*) _userdata, _index, _header_valid, _payload, _rxvector);
+    return 0;
+}
+
+// compare parallel decode with serial one, returning 1 if identical
+int wlancapturesync_compare(struct wlancapturesync_autotest_s * _r0,
+                            struct wlancapturesync_autotest_s * _r1,
+                            unsigned int                        _num_workers,
+                            unsigned int                        _chunk_len)
+{
+    int valid = _r0->num_frames == _r1->num_frames;
+    unsigned int i;
+    for (i=0; valid && i<_r0->num_frames; i++) {
+        valid = _r0->index[i]                == _r1->index[i]                &&
+                _r0->header_valid[i]         == _r1->header_valid[i]         &&
+                _r0->rxvector[i].LENGTH      == _r1->rxvector[i].LENGTH      &&
+                _r0->rxvector[i].DATARATE    == _r1->rxvector[i].DATARATE    &&
+                (!_r0->header_valid[i] ||
+                 memcmp(_r0->payload[i], _r1->payload[i], _r0->rxvector[i].LENGTH) == 0);
+    }
+    if (!valid) {
+        fprintf(stderr,"wlancapturesync_autotest: %u workers, chunk %u: %u frames (serial %u), first mismatch at frame %u\n",
+                _num_workers, _chunk_len, _r1->num_frames, _r0->num_frames, i-1);
+    }
+    return valid;
+}
+
+int main() {
+    unsigned int i;
+    unsigned int j;
+
+    // generate capture: frames of random length and rate separated by
+    // random gaps, with noise and carrier offset
+    unsigned int num_samples_max = NUM_FRAMES*(400 + 80*68 + 3000) + 1000;
+    float complex * x = (float complex*) malloc(num_samples_max*sizeof(float complex));
+    unsigned int n = 0;
+    unsigned int rates[6] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12, WLANFRAME_RATE_18,
+                             WLANFRAME_RATE_24, WLANFRAME_RATE_36, WLANFRAME_RATE_54};
+    unsigned char payload[MAX_LENGTH];
+    wlanframegen fg = wlanframegen_create();
+    srand(1);
+    for (i=0; i<NUM_FRAMES; i++) {
+        unsigned int gap = 300 + rand() % 2700;
+        memset(&x[n], 0x00, gap*sizeof(float complex));
+        n += gap;
+
+        struct wlan_txvector_s txvector = {1 + rand() % MAX_LENGTH, rates[rand() % 6], 0, 0};
+        for (j=0; j<txvector.LENGTH; j++)
+            payload[j] = rand() & 0xff;
+        wlanframegen_assemble(fg, payload, txvector);
+        n += wlanframegen_write_samples(fg, &x[n], num_samples_max - n);
+    }
+    wlanframegen_destroy(fg);
+    memset(&x[n], 0x00, 1000*sizeof(float complex));
+    n += 1000;
+
+    float nstd = powf(10.0f, -25.0f/20.0f);
+    for (i=0; i<n; i++) {
+        x[i] *= cexpf(_Complex_I*0.002f*i);
+        x[i] += nstd*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+    }
+
+    // serial decode
+    struct wlancapturesync_autotest_s * r0 = (struct wlancapturesync_autotest_s*) malloc(sizeof(struct wlancapturesync_autotest_s));
+    struct wlancapturesync_autotest_s * r1 = (struct wlancapturesync_autotest_s*) malloc(sizeof(struct wlancapturesync_autotest_s));
+    r0->num_frames = 0;
+    r0->fs = wlanframesync_create_max_length(serial_callback, r0, MAX_LENGTH);
+    wlanframesync_execute(r0->fs, x, n);
+    wlanframesync_destroy(r0->fs);
+
+    int valid = 1;
+    if (r0->num_frames != NUM_FRAMES) {
+        fprintf(stderr,"wlancapturesync_autotest: serial decode received %u / %u frames\n", r0->num_frames, NUM_FRAMES);
+        valid = 0;
+    }
+
+    // parallel decode: chunks shorter and longer than the overlap, not
+    // dividing the capture, a single chunk, and a chunk boundary less
+    // than a symbol past the end of a frame (within the duplicate guard,
+    // but beyond the synchronizer's processing delay) so that both
+    // neighbouring chunks find it
+    unsigned int num_workers[5] = {3, 2, 4, 1, 2};
+    unsigned int chunk_len[5]   = {20011, 4000, 65536, n, n};
+    if (r0->num_frames > 0)
+        chunk_len[4] = r0->index[r0->num_frames/2] + 64;
+    for (i=0; i<5; i++) {
+        r1->num_frames = 0;
+        wlancapturesync q = wlancapturesync_create(num_workers[i], chunk_len[i], MAX_LENGTH, parallel_callback, r1);
+        unsigned long int num_frames = wlancapturesync_execute(q, x, n);
+        unsigned long int num_duplicates = wlancapturesync_get_num_duplicates(q);
+        if (i == 0 || i == 4)
+            wlancapturesync_print(q);
+        wlancapturesync_destroy(q);
+
+        valid &= num_frames == r1->num_frames;
+        valid &= wlancapturesync_compare(r0, r1, num_workers[i], chunk_len[i]);
+        if (i == 4 && num_duplicates == 0) {
+            fprintf(stderr,"wlancapturesync_autotest: chunk %u: no duplicate frames removed\n", chunk_len[i]);
+            valid = 0;
+        }
+    }
+
+    free(x);
+    free(r0);
+    free(r1);
+
+    if (!valid) {
+        fprintf(stderr,"fail: %s, parallel decode differs from serial decode\n", __FILE__);
+        exit(1);
+    }
+    return 0;
+}
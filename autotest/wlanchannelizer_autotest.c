@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanchannelizer_autotest.c
+//
+// Test channelizer: a tone at a channel center must pass with unity gain
+// and be rejected by all other channels, and distinct frame streams
+// placed on each channel of a wideband capture must be decoded on the
+// right channel
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include <liquid/liquid.h>
+
+#include "liquid-wlan.h"
+
+#define NUM_CHANNELS    (4)
+#define NUM_FRAMES      (3)     // frames per channel
+#define INTERP_SEMILEN  (12)    // interpolation filter semi-length
+
+// per-channel received frame counters
+struct wlanchannelizer_autotest_s {
+    unsigned int channel;
+    unsigned int num_frames;
+    unsigned int num_errors;
+};
+
+static int callback(int                    _header_valid,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    struct wlanchannelizer_autotest_s * testdata = (struct wlanchannelizer_autotest_s*) _userdata;
+
+    // payload identifies channel and frame: [channel, frame, frame+1, ...]
+    unsigned int i;
+    int valid = _header_valid && _rxvector.LENGTH == 100 && _payload[0] == testdata->channel &&
+                _payload[1] == testdata->num_frames;
+    for (i=2; valid && i<_rxvector.LENGTH; i++)
+        valid = _payload[i] == (unsigned char)(_payload[1] + i);
+
+    if (valid) testdata->num_frames++;
+    else       testdata->num_errors++;
+    return 0;
+}
+
+// test gain and rejection of tone at center of channel _k
+int wlanchannelizer_runtest_tone(unsigned int _k)
+{
+    unsigned int M = NUM_CHANNELS;
+    wlanchannelizer q = wlanchannelizer_create(M);
+
+    float complex x[M];
+    float complex y[M];
+    float g[M];             // peak output magnitude per channel
+    unsigned int i;
+    unsigned int j;
+    unsigned int k;
+    for (k=0; k<M; k++)
+        g[k] = 0.0f;
+    for (i=0; i<200; i++) {
+        for (j=0; j<M; j++)
+            x[j] = cexpf(_Complex_I*2*M_PI*_k*(i*M + j)/(float)M);
+        wlanchannelizer_execute_block(q, x, y);
+
+        // skip filter transient
+        if (i < 2*INTERP_SEMILEN) continue;
+        for (k=0; k<M; k++)
+            g[k] = cabsf(y[k]) > g[k] ? cabsf(y[k]) : g[k];
+    }
+    wlanchannelizer_destroy(q);
+
+    int valid = 1;
+    for (k=0; k<M; k++) {
+        if ( (k == _k && fabsf(g[k] - 1.0f) > 1e-3f) ||
+             (k != _k && 20*log10f(g[k]) > -50.0f) )
+        {
+            fprintf(stderr,"wlanchannelizer_autotest: tone on channel %u, channel %u gain %12.8f\n", _k, k, g[k]);
+            valid = 0;
+        }
+    }
+    return valid;
+}
+
+int main() {
+    unsigned int i;
+    unsigned int j;
+    unsigned int k;
+    unsigned int M = NUM_CHANNELS;
+
+    int valid = 1;
+    for (k=0; k<M; k++)
+        valid &= wlanchannelizer_runtest_tone(k);
+
+    // interpolation filter (20 MS/s to M x 20 MS/s)
+    unsigned int h_len = 2*INTERP_SEMILEN*M + 1;
+    float h[h_len];
+    liquid_firdes_kaiser(h_len, 0.5f/(float)M, 60.0f, 0.0f, h);
+    float g = 0.0f;
+    for (i=0; i<h_len; i++)
+        g += h[i];
+    for (i=0; i<h_len; i++)
+        h[i] *= M / g;
+
+    // generate wideband capture: distinct frame stream on each channel,
+    // interpolated and shifted to the channel center
+    unsigned int num_samples = NUM_FRAMES*(3500 + WLANFRAME_DIFS) + WLANFRAME_DIFS;
+    float complex * stream = (float complex*) malloc(num_samples*sizeof(float complex));
+    float complex * x = (float complex*) calloc(M*num_samples, sizeof(float complex));
+    unsigned int rates[4] = {WLANFRAME_RATE_6, WLANFRAME_RATE_12, WLANFRAME_RATE_24, WLANFRAME_RATE_36};
+    wlanframegen fg = wlanframegen_create();
+    for (k=0; k<M; k++) {
+        memset(stream, 0x00, num_samples*sizeof(float complex));
+        struct wlan_txvector_s txvector = {100, rates[k%4], 0, 0};
+        unsigned int n = WLANFRAME_DIFS + 97*k;
+        for (j=0; j<NUM_FRAMES; j++) {
+            unsigned char payload[100];
+            payload[0] = k;
+            payload[1] = j;
+            for (i=2; i<100; i++)
+                payload[i] = j + i;
+            wlanframegen_assemble(fg, payload, txvector);
+            n += wlanframegen_write_samples(fg, &stream[n], num_samples - n);
+            n += WLANFRAME_DIFS;
+        }
+
+        // interpolate, mix up to channel center and add to capture
+        for (i=0; i<M*num_samples; i++) {
+            float complex v = 0.0f;
+            unsigned int p;
+            for (p=i%M; p<h_len && p<=i; p+=M)
+                v += h[p] * stream[(i-p)/M];
+            x[i] += v * cexpf(_Complex_I*2*M_PI*k*(i%M)/(float)M);
+        }
+    }
+    wlanframegen_destroy(fg);
+
+    // channelize capture in irregular blocks into one synchronizer per
+    // channel
+    struct wlanchannelizer_autotest_s testdata[NUM_CHANNELS];
+    wlanframesync fs[NUM_CHANNELS];
+    wlanchannelizer q = wlanchannelizer_create(M);
+    for (k=0; k<M; k++) {
+        testdata[k].channel    = k;
+        testdata[k].num_frames = 0;
+        testdata[k].num_errors = 0;
+        fs[k] = wlanframesync_create(callback, &testdata[k]);
+        wlanchannelizer_set_sync(q, k, fs[k]);
+    }
+    wlanchannelizer_print(q);
+
+    i = 0;
+    while (i < M*num_samples) {
+        unsigned int n = 1 + (i*7 + 301) % 1500;
+        if (n > M*num_samples - i)
+            n = M*num_samples - i;
+        wlanchannelizer_execute(q, &x[i], n);
+        i += n;
+    }
+
+    for (k=0; k<M; k++) {
+        if (testdata[k].num_frames != NUM_FRAMES || testdata[k].num_errors != 0) {
+            fprintf(stderr,"wlanchannelizer_autotest: channel %u (%+d) received %u frames (%u errors)\n",
+                    k, wlanchannelizer_get_channel_offset(q, k),
+                    testdata[k].num_frames, testdata[k].num_errors);
+            valid = 0;
+        }
+        wlanframesync_destroy(fs[k]);
+    }
+    wlanchannelizer_destroy(q);
+    free(stream);
+    free(x);
+
+    if (!valid) {
+        fprintf(stderr,"fail: %s, channelizer failure\n", __FILE__);
+        exit(1);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframe_assemble_autotest.c
+//
+// Test frames assembled independently of the generator: a frame is
+// re-assembled while the previously queued frame is being modulated,
+// and the output is compared against wlanframegen_assemble()
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+#include "wlanframegen_reference.c"
+
+// maximum number of reference samples
+#define NUM_SAMPLES_MAX (8000)
+
+int main() {
+    // options
+    unsigned char * msg_org = annexg_G1;
+    struct wlan_txvector_s txvector[3] = {
+        {100, WLANFRAME_RATE_36, 0, 0},
+        { 37, WLANFRAME_RATE_12, 0, 0},
+        {  1, WLANFRAME_RATE_54, 0, 0}};
+
+    // reference frames, back to back
+    float complex frame_ref[3*NUM_SAMPLES_MAX];
+    unsigned int num_samples = 0;
+    unsigned int i;
+    wlanframegen fg_ref = wlanframegen_create();
+    for (i=0; i<3; i++) {
+        num_samples += wlanframegen_reference(fg_ref, msg_org, txvector[i],
+                                              &frame_ref[num_samples],
+                                              3*NUM_SAMPLES_MAX - num_samples);
+    }
+    wlanframegen_destroy(fg_ref);
+
+    // assemble first two frames outside of generator
+    wlanframe frame[2];
+    frame[0] = wlanframe_create();
+    frame[1] = wlanframe_create();
+    wlanframe_assemble(frame[0], msg_org, txvector[0]);
+    wlanframe_assemble(frame[1], msg_org, txvector[1]);
+
+    wlanframegen fg = wlanframegen_create();
+
+    // the unsupported 9 M bits/s rate is reported, leaving the generator
+    // untouched
+    struct wlan_txvector_s txvector_9 = {100, WLANFRAME_RATE_9, 0, 0};
+    if (wlanframegen_assemble(fg, msg_org, txvector_9) != -1 ||
+        wlanframegen_queue   (fg, msg_org, txvector_9) != -1)
+    {
+        fprintf(stderr,"fail: %s, unsupported rate not reported\n", __FILE__);
+        exit(1);
+    }
+
+    if (wlanframegen_queue_frame(fg, frame[0]) ||
+        wlanframegen_queue_frame(fg, frame[1]))
+    {
+        fprintf(stderr,"fail: %s, could not queue frames\n", __FILE__);
+        exit(1);
+    }
+
+    // generate first frame; second frame is loaded from queue on the
+    // following call, at which point the first may be re-assembled
+    float complex y[3*NUM_SAMPLES_MAX];
+    unsigned int n0 = wlanframe_get_num_samples(frame[0]);
+    unsigned int n  = wlanframegen_write_samples(fg, y, n0);
+    n += wlanframegen_write_samples(fg, &y[n], 80);
+    wlanframe_assemble(frame[0], msg_org, txvector[2]);
+    if (wlanframegen_queue_frame(fg, frame[0])) {
+        fprintf(stderr,"fail: %s, could not queue frame\n", __FILE__);
+        exit(1);
+    }
+    while (n < num_samples) {
+        unsigned int k = num_samples - n < 203 ? num_samples - n : 203;
+        n += wlanframegen_write_samples(fg, &y[n], k);
+    }
+    wlanframegen_destroy(fg);
+    wlanframe_destroy(frame[0]);
+    wlanframe_destroy(frame[1]);
+
+    // check results
+    unsigned int num_errors = 0;
+    for (i=0; i<num_samples; i++) {
+        if (cabsf(y[i] - frame_ref[i]) > 1e-6f)
+            num_errors++;
+    }
+    printf("num sample errors : %4u / %4u\n", num_errors, num_samples);
+
+    if (num_errors > 0) {
+        fprintf(stderr,"fail: %s, failure\n", __FILE__);
+        exit(1);
+    }
+
+    printf("done.\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframecache_autotest.c
+//
+// Test replay of cached frame waveforms against uncached generation,
+// hit accounting and eviction under a memory budget
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+#include "wlanframegen_reference.c"
+
+// maximum number of reference samples
+#define NUM_SAMPLES_MAX (8000)
+
+int main() {
+    // options
+    unsigned char * msg_org = annexg_G1;
+    struct wlan_txvector_s txvector_a = {100, WLANFRAME_RATE_36, 0, 0};
+    struct wlan_txvector_s txvector_b = { 37, WLANFRAME_RATE_12, 0, 0};
+
+    // reference sequence: a, b, a, a
+    float complex frame_a[NUM_SAMPLES_MAX];
+    float complex frame_b[NUM_SAMPLES_MAX];
+    wlanframegen fg_ref = wlanframegen_create();
+    unsigned int na = wlanframegen_reference(fg_ref, msg_org, txvector_a, frame_a, NUM_SAMPLES_MAX);
+    unsigned int nb = wlanframegen_reference(fg_ref, msg_org, txvector_b, frame_b, NUM_SAMPLES_MAX);
+    wlanframegen_destroy(fg_ref);
+
+    float complex frame_ref[4*NUM_SAMPLES_MAX];
+    unsigned int num_samples = 0;
+    memmove(&frame_ref[num_samples], frame_a, na*sizeof(float complex)); num_samples += na;
+    memmove(&frame_ref[num_samples], frame_b, nb*sizeof(float complex)); num_samples += nb;
+    memmove(&frame_ref[num_samples], frame_a, na*sizeof(float complex)); num_samples += na;
+    memmove(&frame_ref[num_samples], frame_a, na*sizeof(float complex)); num_samples += na;
+
+    // generate same sequence through cache with irregular buffer sizes
+    wlanframecache cache = wlanframecache_create(1<<20);
+    wlanframegen fg = wlanframegen_create();
+    wlanframegen_set_cache(fg, cache);
+
+    struct wlan_txvector_s * txvector[4] = {&txvector_a, &txvector_b, &txvector_a, &txvector_a};
+    float complex y[4*NUM_SAMPLES_MAX];
+    unsigned int buffer_len[4] = {37, 80, 1, 203};
+    unsigned int n = 0;
+    unsigned int num_queued = 0;
+    unsigned int i = 0;
+    while (n < num_samples) {
+        // keep queue full
+        while (num_queued < 4 && wlanframegen_queue(fg, msg_org, *txvector[num_queued]) == 0)
+            num_queued++;
+
+        unsigned int k = buffer_len[i++ % 4];
+        if (n + k > num_samples) k = num_samples - n;
+        n += wlanframegen_write_samples(fg, &y[n], k);
+    }
+
+    // check results
+    unsigned int num_errors = 0;
+    for (i=0; i<num_samples; i++) {
+        if (cabsf(y[i] - frame_ref[i]) > 1e-6f)
+            num_errors++;
+    }
+    printf("num sample errors : %4u / %4u\n", num_errors, num_samples);
+    wlanframecache_print(cache);
+
+    if (num_errors > 0 ||
+        wlanframecache_get_num_lookups(cache) != 4 ||
+        wlanframecache_get_num_hits(cache)    != 2 ||
+        wlanframecache_get_num_entries(cache) != 2)
+    {
+        fprintf(stderr,"fail: %s, failure\n", __FILE__);
+        exit(1);
+    }
+    wlanframegen_destroy(fg);
+    wlanframecache_destroy(cache);
+
+    // budget holding only frame 'b': inserting 'a' evicts 'b' and vice
+    // versa
+    cache = wlanframecache_create(1<<20);
+    fg = wlanframegen_create();
+    wlanframegen_set_cache(fg, cache);
+    wlanframegen_assemble(fg, msg_org, txvector_b);
+    unsigned int budget = wlanframecache_get_num_bytes(cache);
+    wlanframegen_destroy(fg);
+    wlanframecache_destroy(cache);
+
+    cache = wlanframecache_create(budget);
+    fg = wlanframegen_create();
+    wlanframegen_set_cache(fg, cache);
+    wlanframegen_assemble(fg, msg_org, txvector_b);
+    wlanframegen_reset(fg);
+    wlanframegen_assemble(fg, msg_org, txvector_a);
+    wlanframegen_reset(fg);
+    wlanframegen_assemble(fg, msg_org, txvector_b);
+    unsigned int m = wlanframegen_write_samples(fg, y, nb + 80);
+    wlanframecache_print(cache);
+
+    num_errors = 0;
+    for (i=0; i<nb; i++) {
+        if (cabsf(y[i] - frame_b[i]) > 1e-6f)
+            num_errors++;
+    }
+    if (num_errors > 0 || m != nb ||
+        wlanframecache_get_num_hits(cache)    != 0 ||
+        wlanframecache_get_num_entries(cache) != 1 ||
+        wlanframecache_get_num_bytes(cache)   >  budget)
+    {
+        fprintf(stderr,"fail: %s, eviction failure\n", __FILE__);
+        exit(1);
+    }
+    wlanframegen_destroy(fg);
+    wlanframecache_destroy(cache);
+
+    printf("done.\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframegen_reference.c
+//
+// Reference frame for generator autotests: the frame written one OFDM
+// symbol at a time with wlanframegen_writesymbol(). Included directly by
+// the autotest programs which compare against it.
+//
+
+// generate reference frame symbol-by-symbol with generator _fg, returning
+// number of samples written to _frame (at most _frame_len)
+static unsigned int wlanframegen_reference(wlanframegen           _fg,
+                                           unsigned char *        _payload,
+                                           struct wlan_txvector_s _txvector,
+                                           float complex *        _frame,
+                                           unsigned int           _frame_len)
+{
+    wlanframegen_reset(_fg);
+    wlanframegen_assemble(_fg, _payload, _txvector);
+
+    unsigned int n = 0;
+    int last_symbol = 0;
+    while (!last_symbol) {
+        if (n + 80 > _frame_len) {
+            fprintf(stderr,"fail: %s, reference buffer too small\n", __FILE__);
+            exit(1);
+        }
+        last_symbol = wlanframegen_writesymbol(_fg, &_frame[n]);
+        n += 80;
+    }
+    return n;
+}
+
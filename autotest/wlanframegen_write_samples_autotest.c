@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanframegen_write_samples_autotest.c
+//
+// Test streaming output of back-to-back frames with arbitrary buffer
+// sizes against symbol-by-symbol generation
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid-wlan.h"
+
+#include "annex-g-data/G1.c"
+#include "wlanframegen_reference.c"
+
+// maximum number of reference samples
+#define NUM_SAMPLES_MAX (8000)
+
+int main() {
+    // options
+    unsigned char * msg_org = annexg_G1;
+    struct wlan_txvector_s txvector_a = {100, WLANFRAME_RATE_36, 0, 0};
+    struct wlan_txvector_s txvector_b = { 37, WLANFRAME_RATE_12, 0, 0};
+
+    // reference frames, back to back, followed by zero padding
+    float complex frame_ref[2*NUM_SAMPLES_MAX];
+    wlanframegen fg_ref = wlanframegen_create();
+    unsigned int na = wlanframegen_reference(fg_ref, msg_org, txvector_a, frame_ref, 2*NUM_SAMPLES_MAX);
+    unsigned int nb = wlanframegen_reference(fg_ref, msg_org, txvector_b, &frame_ref[na], 2*NUM_SAMPLES_MAX - na);
+    wlanframegen_destroy(fg_ref);
+    unsigned int num_samples = na + nb + 500;
+    memset(&frame_ref[na+nb], 0x00, 500*sizeof(float complex));
+
+    // stream both frames with irregular buffer sizes
+    float complex frame[2*NUM_SAMPLES_MAX];
+    unsigned int buffer_len[5] = {37, 80, 1, 4096, 203};
+    wlanframegen fg = wlanframegen_create();
+    if (wlanframegen_queue(fg, msg_org, txvector_a) ||
+        wlanframegen_queue(fg, msg_org, txvector_b))
+    {
+        fprintf(stderr,"fail: %s, could not queue frames\n", __FILE__);
+        exit(1);
+    }
+
+    unsigned int n = 0;
+    unsigned int num_written = 0;
+    unsigned int i = 0;
+    while (n < num_samples) {
+        unsigned int k = buffer_len[i++ % 5];
+        if (n + k > num_samples) k = num_samples - n;
+        num_written += wlanframegen_write_samples(fg, &frame[n], k);
+        n += k;
+    }
+    wlanframegen_destroy(fg);
+
+    // check results
+    unsigned int num_errors = 0;
+    for (i=0; i<num_samples; i++) {
+        if (cabsf(frame[i] - frame_ref[i]) > 1e-6f)
+            num_errors++;
+    }
+    printf("num sample errors : %4u / %4u\n", num_errors, num_samples);
+    printf("frame samples     : %4u (expected %4u)\n", num_written, na+nb);
+
+    if (num_errors > 0 || num_written != na + nb) {
+        fprintf(stderr,"fail: %s, failure\n", __FILE__);
+        exit(1);
+    }
+
+    printf("done.\n");
+    return 0;
+}
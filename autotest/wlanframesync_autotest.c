@@ -51,6 +51,27 @@ void usage()
 // run test with a specific rate
 int wlanframesync_runtest(unsigned int _rate);
 
+// run test with maximum payload length accepted by synchronizer
+int wlanframesync_runtest_max_length(unsigned int _rate,
+                                     unsigned int _length,
+                                     unsigned int _max_length);
+
+// run test with integer samples, alternating with float samples
+int wlanframesync_runtest_int(unsigned int _rate,
+                              int          _format);
+
+// run test with random rates (up to _max_rate) and lengths through
+// channel (noise, carrier frequency offset) with input pushed in
+// odd-sized blocks
+int wlanframesync_runtest_channel(unsigned int _max_rate,
+                                  unsigned int _num_frames,
+                                  float        _SNRdB,
+                                  float        _dphi);
+
+// run noise-only input stepping through noise levels, checking that the
+// noise floor estimate follows
+int wlanframesync_runtest_noise_floor(void);
+
 // callback function
 static int callback(int                    _header_valid,
                     unsigned char *        _payload,
@@ -68,6 +89,26 @@ int main() {
     wlanframesync_runtest(WLANFRAME_RATE_48);
     wlanframesync_runtest(WLANFRAME_RATE_54);
 
+    // longest frames (message buffers sized once at create time)
+    wlanframesync_runtest_max_length(WLANFRAME_RATE_6,  4095, 4095);
+    wlanframesync_runtest_max_length(WLANFRAME_RATE_54, 4095, 4095);
+
+    // frames exceeding (or at) the length cap
+    wlanframesync_runtest_max_length(WLANFRAME_RATE_12, 100, 99);
+    wlanframesync_runtest_max_length(WLANFRAME_RATE_12, 100, 100);
+
+    // integer sample input
+    wlanframesync_runtest_int(WLANFRAME_RATE_12, WLAN_IQ_CI16);
+    wlanframesync_runtest_int(WLANFRAME_RATE_54, WLAN_IQ_CI16);
+    wlanframesync_runtest_int(WLANFRAME_RATE_12, WLAN_IQ_CI8);
+
+    // noise, carrier frequency offset (64-QAM rates need about 25 dB)
+    wlanframesync_runtest_channel(WLANFRAME_RATE_54, 200, 30.0f, 0.002f);
+    wlanframesync_runtest_channel(WLANFRAME_RATE_36, 200, 20.0f, 0.002f);
+
+    // noise floor tracking
+    wlanframesync_runtest_noise_floor();
+
     return 0;
 }
 
@@ -154,6 +195,16 @@ int wlanframesync_runtest(unsigned int _rate)
         wlanframesync_execute(fs, buffer, 80);
     }
 
+    // check detection statistics: one detection, no false alarms
+    if (wlanframesync_get_num_detections(fs)    != 1 ||
+        wlanframesync_get_num_s1_timeouts(fs)   != 0 ||
+        wlanframesync_get_num_signal_errors(fs) != 0)
+    {
+        fprintf(stderr,"wlanframesync_autotest: unexpected detection statistics!\n");
+        wlanframesync_print(fs);
+        testdata.valid = 0;
+    }
+
     // destroy objects
     wlanframegen_destroy(fg);
     wlanframesync_destroy(fs);
@@ -172,6 +223,317 @@ int wlanframesync_runtest(unsigned int _rate)
     return 0;
 }
 
+// callback for max-length test: count valid frames, payload matching
+static int callback_max_length(int                    _header_valid,
+                               unsigned char *        _payload,
+                               struct wlan_rxvector_s _rxvector,
+                               void *                 _userdata)
+{
+    struct wlanframesync_autotest_s * testdata = (struct wlanframesync_autotest_s*) _userdata;
+    if (_header_valid && _rxvector.LENGTH == testdata->length &&
+        memcmp(_payload, testdata->msg_org, _rxvector.LENGTH) == 0)
+    {
+        testdata->num_frames++;
+    }
+    return 0;
+}
+
+int wlanframesync_runtest_max_length(unsigned int _rate,
+                                     unsigned int _length,
+                                     unsigned int _max_length)
+{
+    // random payload
+    unsigned char msg_org[4095];
+    unsigned int i;
+    for (i=0; i<_length; i++)
+        msg_org[i] = rand() & 0xff;
+
+    struct wlan_txvector_s txvector;
+    txvector.LENGTH      = _length;
+    txvector.DATARATE    = _rate;
+    txvector.SERVICE     = 0;
+    txvector.TXPWR_LEVEL = 0;
+
+    struct wlanframesync_autotest_s testdata;
+    testdata.msg_org    = msg_org;
+    testdata.length     = _length;
+    testdata.datarate   = _rate;
+    testdata.num_frames = 0;
+    testdata.valid      = 1;
+
+    // generate/synchronize frame
+    wlanframegen  fg = wlanframegen_create();
+    wlanframesync fs = wlanframesync_create_max_length(callback_max_length, (void*)&testdata, _max_length);
+    wlanframegen_assemble(fg, msg_org, txvector);
+
+    float complex buffer[80];
+    int last_frame = 0;
+    while (!last_frame) {
+        last_frame = wlanframegen_writesymbol(fg, buffer);
+        wlanframesync_execute(fs, buffer, 80);
+    }
+
+    // frame must be decoded only if it fits, otherwise the header is
+    // reported invalid
+    unsigned int num_expected = _length <= _max_length ? 1 : 0;
+    if (testdata.num_frames != num_expected ||
+        wlanframesync_get_num_signal_errors(fs) != 1 - num_expected)
+    {
+        fprintf(stderr,"fail: %s, max length failure (rate = %u, length = %u, max = %u)\n",
+                __FILE__, _rate, _length, _max_length);
+        exit(1);
+    }
+    printf("max length %4u, length %4u : %u frame(s)\n", _max_length, _length, testdata.num_frames);
+
+    wlanframegen_destroy(fg);
+    wlanframesync_destroy(fs);
+    return 0;
+}
+
+int wlanframesync_runtest_int(unsigned int _rate,
+                              int          _format)
+{
+    // random payload
+    unsigned char msg_org[100];
+    unsigned int i;
+    for (i=0; i<100; i++)
+        msg_org[i] = rand() & 0xff;
+
+    struct wlan_txvector_s txvector;
+    txvector.LENGTH      = 100;
+    txvector.DATARATE    = _rate;
+    txvector.SERVICE     = 0;
+    txvector.TXPWR_LEVEL = 0;
+
+    struct wlanframesync_autotest_s testdata;
+    testdata.msg_org    = msg_org;
+    testdata.length     = 100;
+    testdata.datarate   = _rate;
+    testdata.num_frames = 0;
+    testdata.valid      = 1;
+
+    // generate frame at about -18 dBFS between noisy gaps
+    float complex frame[4000];
+    wlanframegen fg = wlanframegen_create();
+    wlanframegen_assemble(fg, msg_org, txvector);
+    unsigned int frame_len = wlanframegen_write_samples(fg, frame, 4000);
+    wlanframegen_destroy(fg);
+
+    unsigned int n = 400 + frame_len + 400;
+    float complex x[n];
+    for (i=0; i<n; i++) {
+        x[i] = 0.003f*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+        if (i >= 400 && i < 400 + frame_len)
+            x[i] += 0.125f*frame[i-400];
+    }
+
+    // quantize (clipping at full scale), keeping the float samples equal
+    // to the quantized ones
+    float full_scale = _format == WLAN_IQ_CI16 ? 32768.0f : 128.0f;
+    int16_t x16[2*n];
+    int8_t  x8[2*n];
+    for (i=0; i<2*n; i++) {
+        float v = ((float*)x)[i] * full_scale;
+        v = v > full_scale - 1 ? full_scale - 1 : (v < -full_scale ? -full_scale : v);
+        x16[i] = (int16_t)lrintf(v);
+        x8[i]  = (int8_t) lrintf(v);
+        ((float*)x)[i] = (float)lrintf(v) / full_scale;
+    }
+
+    // decode float samples and the same samples as integers (in uneven
+    // blocks) with separate synchronizers: the integer scale is carried
+    // by the gain, so the levels reported must agree. The integer
+    // samples are then run through the float synchronizer as well.
+    wlanframesync fs0 = wlanframesync_create(callback_max_length, (void*)&testdata);
+    wlanframesync fs1 = wlanframesync_create(callback_max_length, (void*)&testdata);
+    wlanframesync_execute(fs0, x, n);
+
+    unsigned int j;
+    for (j=0; j<2; j++) {
+        wlanframesync fs = j == 0 ? fs1 : fs0;
+        i = 0;
+        while (i < n) {
+            unsigned int k = 1 + (7*i + 13) % 200;
+            if (k > n - i) k = n - i;
+            if (_format == WLAN_IQ_CI16) wlanframesync_execute_sc16(fs, &x16[2*i], k);
+            else                         wlanframesync_execute_sc8 (fs, &x8 [2*i], k);
+            i += k;
+        }
+        if (j == 0 && (fabsf(wlanframesync_get_rssi(fs0)        - wlanframesync_get_rssi(fs1))        > 0.01f ||
+                       fabsf(wlanframesync_get_noise_floor(fs0) - wlanframesync_get_noise_floor(fs1)) > 0.01f))
+        {
+            fprintf(stderr,"wlanframesync_autotest: rssi %.2f/%.2f dB, noise floor %.2f/%.2f dB\n",
+                    wlanframesync_get_rssi(fs0), wlanframesync_get_rssi(fs1),
+                    wlanframesync_get_noise_floor(fs0), wlanframesync_get_noise_floor(fs1));
+            testdata.valid = 0;
+        }
+    }
+
+    if (testdata.num_frames != 3 || !testdata.valid) {
+        fprintf(stderr,"fail: %s, integer input failure (rate = %u, format = %d, %u frames)\n",
+                __FILE__, _rate, _format, testdata.num_frames);
+        exit(1);
+    }
+    printf("integer input (format %d) : %u frame(s), rssi %.2f dB\n",
+            _format, testdata.num_frames, wlanframesync_get_rssi(fs1));
+
+    wlanframesync_destroy(fs0);
+    wlanframesync_destroy(fs1);
+    return 0;
+}
+
+// callback for channel test: count frames by outcome
+static int callback_channel(int                    _header_valid,
+                            unsigned char *        _payload,
+                            struct wlan_rxvector_s _rxvector,
+                            void *                 _userdata)
+{
+    struct wlanframesync_autotest_s * testdata = (struct wlanframesync_autotest_s*) _userdata;
+    if (_header_valid && _rxvector.LENGTH == testdata->length &&
+        _rxvector.DATARATE == testdata->datarate &&
+        memcmp(_payload, testdata->msg_org, _rxvector.LENGTH) == 0)
+    {
+        testdata->num_frames++;
+    } else {
+        testdata->valid = 0;
+    }
+    return 0;
+}
+
+int wlanframesync_runtest_channel(unsigned int _max_rate,
+                                  unsigned int _num_frames,
+                                  float        _SNRdB,
+                                  float        _dphi)
+{
+    // fixed seed so that any failure can be reproduced
+    srand(_num_frames + (unsigned int)(100*_SNRdB));
+
+    // supported rates up to _max_rate (9 M bits/s is not supported)
+    unsigned int rates[7] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12, WLANFRAME_RATE_18,
+                             WLANFRAME_RATE_24, WLANFRAME_RATE_36, WLANFRAME_RATE_48,
+                             WLANFRAME_RATE_54};
+    unsigned int num_rates = 0;
+    while (num_rates < 7 && rates[num_rates] <= _max_rate)
+        num_rates++;
+
+    unsigned char msg_org[400];
+    struct wlanframesync_autotest_s testdata;
+    testdata.msg_org    = msg_org;
+    testdata.num_frames = 0;
+
+    wlanframegen  fg = wlanframegen_create();
+    wlanframesync fs = wlanframesync_create(callback_channel, (void*)&testdata);
+
+    // noise standard deviation relative to (unit) signal level
+    float nstd = powf(10.0f, -_SNRdB/20.0f);
+    float phi  = 2*M_PI*randf();    // carrier phase
+
+    float complex frame[16000];
+    float complex y[500 + 16000 + 500];
+    unsigned int num_failures = 0;
+    unsigned int t;
+    unsigned int i;
+    for (t=0; t<_num_frames; t++) {
+        // random rate, length and payload
+        struct wlan_txvector_s txvector;
+        txvector.LENGTH      = 1 + rand() % 400;
+        txvector.DATARATE    = rates[rand() % num_rates];
+        txvector.SERVICE     = 0;
+        txvector.TXPWR_LEVEL = 0;
+        for (i=0; i<txvector.LENGTH; i++)
+            msg_org[i] = rand() & 0xff;
+
+        testdata.length   = txvector.LENGTH;
+        testdata.datarate = txvector.DATARATE;
+        testdata.valid    = 1;
+        unsigned int num_frames = testdata.num_frames;
+
+        // generate frame, measuring its level
+        wlanframegen_assemble(fg, msg_org, txvector);
+        unsigned int frame_len = wlanframegen_write_samples(fg, frame, 16000);
+        float e = 0.0f;
+        for (i=0; i<frame_len; i++)
+            e += crealf(frame[i] * conjf(frame[i]));
+        float g = 1.0f / sqrtf(e / (float)frame_len);
+
+        // random delay, frame, trailing gap through channel
+        unsigned int d = 100 + rand() % 400;
+        unsigned int n = d + frame_len + 500;
+        for (i=0; i<n; i++) {
+            y[i] = (i >= d && i < d + frame_len) ? g*frame[i-d] : 0.0f;
+            y[i] *= cexpf(_Complex_I*phi);
+            y[i] += nstd*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+            phi += _dphi;
+        }
+
+        // run through synchronizer in odd-sized blocks
+        i = 0;
+        while (i < n) {
+            unsigned int k = 1 + 2*(rand() % 128);
+            if (k > n - i) k = n - i;
+            wlanframesync_execute(fs, &y[i], k);
+            i += k;
+        }
+
+        // frame must be decoded exactly once
+        if (testdata.num_frames != num_frames + 1 || !testdata.valid) {
+            printf("  frame %3u (rate %u, length %3u) not decoded\n",
+                    t, txvector.DATARATE, txvector.LENGTH);
+            testdata.num_frames = num_frames;
+            num_failures++;
+        }
+    }
+
+    wlanframegen_destroy(fg);
+    wlanframesync_destroy(fs);
+
+    if (num_failures > 0) {
+        fprintf(stderr,"fail: %s, channel failure (SNR = %.1f dB, dphi = %.4f, %u / %u frames)\n",
+                __FILE__, _SNRdB, _dphi, num_failures, _num_frames);
+        exit(1);
+    }
+    printf("channel SNR %4.1f dB, dphi %.4f, rates <= %u : %u / %u frames\n",
+            _SNRdB, _dphi, _max_rate, testdata.num_frames, _num_frames);
+    return 0;
+}
+
+int wlanframesync_runtest_noise_floor(void)
+{
+    srand(0);
+
+    struct wlanframesync_autotest_s testdata;
+    testdata.num_frames = 0;
+    wlanframesync fs = wlanframesync_create(callback, (void*)&testdata);
+
+    // start within a burst (random QPSK at unit power, which the gate does
+    // not pass), then step the noise level up and down [dB]
+    float complex y[40000];
+    unsigned int i;
+    for (i=0; i<500; i++)
+        y[i] = cexpf(_Complex_I*(M_PI/4 + (M_PI/2)*(rand() % 4)));
+    wlanframesync_execute(fs, y, 500);
+
+    float levels[5] = {-40.0f, -20.0f, -10.0f, -40.0f, -30.0f};
+    unsigned int j;
+    for (j=0; j<5; j++) {
+        float nstd = powf(10.0f, levels[j]/20.0f);
+        for (i=0; i<40000; i++)
+            y[i] = nstd*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+        wlanframesync_execute(fs, y, 40000);
+
+        float noise_floor = wlanframesync_get_noise_floor(fs);
+        if (fabsf(noise_floor - levels[j]) > 1.0f) {
+            fprintf(stderr,"fail: %s, noise floor %.2f dB, expected %.2f dB\n",
+                    __FILE__, noise_floor, levels[j]);
+            exit(1);
+        }
+        printf("noise level %6.2f dB : noise floor %6.2f dB\n", levels[j], noise_floor);
+    }
+
+    wlanframesync_destroy(fs);
+    return 0;
+}
+
 static int callback(int                    _header_valid,
                     unsigned char *        _payload,
                     struct wlan_rxvector_s _rxvector,
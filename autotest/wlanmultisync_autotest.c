@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanmultisync_autotest.c
+//
+// Test multi-channel reception: distinct frame streams pushed onto each
+// channel in irregular blocks must be decoded on the right channel, and
+// samples not fitting the queue must be reported as overflows
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "liquid-wlan.h"
+
+#define NUM_CHANNELS    (8)
+#define NUM_WORKERS     (3)
+#define NUM_FRAMES      (4)     // frames per channel
+#define QUEUE_LEN       (16384)
+
+// per-channel received frame counters (callbacks for one channel are
+// never concurrent)
+struct wlanmultisync_autotest_s {
+    unsigned int num_frames[NUM_CHANNELS];
+    unsigned int num_errors[NUM_CHANNELS];
+};
+
+static int callback(unsigned int           _channel,
+                    int                    _header_valid,
+                    unsigned char *        _payload,
+                    struct wlan_rxvector_s _rxvector,
+                    void *                 _userdata)
+{
+    struct wlanmultisync_autotest_s * testdata = (struct wlanmultisync_autotest_s*) _userdata;
+
+    // payload identifies channel and frame: [channel, frame, frame+1, ...]
+    unsigned int i;
+    int valid = _header_valid && _rxvector.LENGTH == 60 && _payload[0] == _channel &&
+                _payload[1] == testdata->num_frames[_channel];
+    for (i=2; valid && i<_rxvector.LENGTH; i++)
+        valid = _payload[i] == (unsigned char)(_payload[1] + i);
+
+    if (valid) testdata->num_frames[_channel]++;
+    else       testdata->num_errors[_channel]++;
+    return 0;
+}
+
+int main() {
+    unsigned int i;
+    unsigned int j;
+    unsigned int k;
+
+    // generate per-channel streams: frames at channel-dependent rates
+    // separated by inter-frame gaps
+    unsigned int rates[4] = {WLANFRAME_RATE_6, WLANFRAME_RATE_12, WLANFRAME_RATE_36, WLANFRAME_RATE_54};
+    unsigned int num_samples_max = NUM_FRAMES*(4000 + WLANFRAME_DIFS) + WLANFRAME_DIFS;
+    float complex * streams[NUM_CHANNELS];
+    unsigned int num_samples[NUM_CHANNELS];
+    wlanframegen fg = wlanframegen_create();
+    for (i=0; i<NUM_CHANNELS; i++) {
+        streams[i] = (float complex*) calloc(num_samples_max, sizeof(float complex));
+        struct wlan_txvector_s txvector = {60, rates[i%4], 0, 0};
+        unsigned int n = WLANFRAME_DIFS;
+        for (j=0; j<NUM_FRAMES; j++) {
+            unsigned char payload[60];
+            payload[0] = i;
+            payload[1] = j;
+            for (k=2; k<60; k++)
+                payload[k] = j + k;
+            wlanframegen_assemble(fg, payload, txvector);
+            n += wlanframegen_write_samples(fg, &streams[i][n], num_samples_max - n);
+            n += WLANFRAME_DIFS;
+        }
+        num_samples[i] = n;
+    }
+    wlanframegen_destroy(fg);
+
+    // push streams interleaved across channels in irregular blocks,
+    // re-pushing samples the queue could not accept
+    struct wlanmultisync_autotest_s testdata;
+    memset(&testdata, 0x00, sizeof(testdata));
+    wlanmultisync q = wlanmultisync_create(NUM_CHANNELS, NUM_WORKERS, QUEUE_LEN, callback, &testdata);
+    wlanmultisync_pin_workers(q);
+
+    unsigned int index[NUM_CHANNELS] = {0};
+    int pending = 1;
+    while (pending) {
+        pending = 0;
+        for (i=0; i<NUM_CHANNELS; i++) {
+            unsigned int n = 97 + 131*i + (index[i] % 1000);
+            if (n > num_samples[i] - index[i])
+                n = num_samples[i] - index[i];
+            index[i] += wlanmultisync_push(q, i, &streams[i][index[i]], n);
+            pending |= index[i] < num_samples[i];
+        }
+    }
+    wlanmultisync_wait(q);
+
+    int valid = 1;
+    for (i=0; i<NUM_CHANNELS; i++) {
+        if (testdata.num_frames[i] != NUM_FRAMES || testdata.num_errors[i] != 0 ||
+            wlanmultisync_get_num_frames(q, i) != NUM_FRAMES ||
+            wlanmultisync_get_backlog(q, i) != 0)
+        {
+            fprintf(stderr,"wlanmultisync_autotest: channel %u received %u frames (%u errors)\n",
+                    i, testdata.num_frames[i], testdata.num_errors[i]);
+            valid = 0;
+        }
+    }
+
+    // push more than the queue holds onto a drained channel: the excess
+    // must be rejected and counted
+    unsigned long int num_overflows = wlanmultisync_get_num_overflows(q, 0);
+    float complex * block = (float complex*) calloc(QUEUE_LEN + 1000, sizeof(float complex));
+    unsigned int n = wlanmultisync_push(q, 0, block, QUEUE_LEN + 1000);
+    if (n != QUEUE_LEN || wlanmultisync_get_num_overflows(q, 0) != num_overflows + 1000) {
+        fprintf(stderr,"wlanmultisync_autotest: overflow not reported (accepted %u)\n", n);
+        valid = 0;
+    }
+    wlanmultisync_wait(q);
+    wlanmultisync_print(q);
+
+    wlanmultisync_destroy(q);
+    free(block);
+    for (i=0; i<NUM_CHANNELS; i++)
+        free(streams[i]);
+
+    if (!valid) {
+        fprintf(stderr,"fail: %s, multi-channel reception failure\n", __FILE__);
+        exit(1);
+    }
+    return 0;
+}
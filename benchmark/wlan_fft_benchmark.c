@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <sys/resource.h>
+#include "liquid-wlan.internal.h"
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlan_fft_benchmark(struct rusage *     _start,
+                        struct rusage *     _finish,
+                        unsigned long int * _num_iterations,
+                        int                 _direction,
+                        int                 _flags)
+{
+    unsigned long int i;
+
+    // create arrays, zeroing NULL subcarriers
+    float complex x[64];
+    float complex y[64];
+    for (i=0; i<64; i++) {
+        x[i] = (i == 0 || (i>26 && i<38)) ? 0.0f : cexpf(_Complex_I*0.1f*i*i);
+        y[i] = 0.0f;
+    }
+
+    // create transform object
+    wlan_fft q = wlan_fft_create(x, y, _direction, _flags);
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        wlan_fft_execute(q);
+        wlan_fft_execute(q);
+        wlan_fft_execute(q);
+        wlan_fft_execute(q);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    // set number of iterations to number of transforms
+    *_num_iterations *= 4;
+
+    // destroy transform object
+    wlan_fft_destroy(q);
+}
+
+int main() {
+    struct rusage start, finish;
+
+    // run benchmark(s) across backends
+    int backends[3] = {WLAN_FFT_BACKEND_LIQUID,
+                       WLAN_FFT_BACKEND_FFTW,
+                       WLAN_FFT_BACKEND_BUILTIN};
+    const char * names[3] = {"liquid", "fftw", "builtin"};
+    unsigned int i;
+    for (i=0; i<3; i++) {
+        if (wlan_fft_set_backend(backends[i]) != 0) {
+            printf("wlan_fft (%-7s)         : unavailable\n", names[i]);
+            continue;
+        }
+
+        // forward transform
+        unsigned long int n = 1000000;
+        wlan_fft_benchmark(&start, &finish, &n, WLAN_FFT_FORWARD, 0);
+        float extime = calculate_execution_time(start, finish);
+        printf("wlan_fft (%-7s, fwd)    : time : %8.5f s, iterations : %8lu (%10.4e transforms/s)\n",
+                names[i], extime, n, (float)n/extime);
+
+        // inverse transform, NULL subcarriers skipped
+        n = 1000000;
+        wlan_fft_benchmark(&start, &finish, &n, WLAN_FFT_BACKWARD, WLAN_FFT_FLAG_NULLS);
+        extime = calculate_execution_time(start, finish);
+        printf("wlan_fft (%-7s, inv)    : time : %8.5f s, iterations : %8lu (%10.4e transforms/s)\n",
+                names[i], extime, n, (float)n/extime);
+    }
+    
+    return 0;
+}
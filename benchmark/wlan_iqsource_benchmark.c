@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_iqsource_benchmark.c
+//
+// Sustained IQ recording read rate (conversion to complex float straight
+// from the page cache) for each sample format
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <liquid/liquid.h>
+#include "liquid-wlan.h"
+
+#define RECORDING_LEN   (1<<22) // samples in recording
+#define BLOCK_LEN       (1<<14) // samples per read
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlan_iqsource_benchmark(struct rusage *     _start,
+                             struct rusage *     _finish,
+                             unsigned long int * _num_iterations,
+                             const char *        _filename,
+                             int                 _format)
+{
+    // write recording of noise (and read it once so that it is cached)
+    unsigned int sample_size = _format == WLAN_IQ_CF32 ? 8 : (_format == WLAN_IQ_CI16 ? 4 : 2);
+    unsigned char * data = (unsigned char*) malloc(RECORDING_LEN*sample_size);
+    unsigned long int i;
+    for (i=0; i<RECORDING_LEN*sample_size; i++)
+        data[i] = rand() & 0xff;
+    if (_format == WLAN_IQ_CF32) {
+        float * v = (float*) data;
+        for (i=0; i<2*RECORDING_LEN; i++)
+            v[i] = randnf();
+    }
+    FILE * fid = fopen(_filename, "w");
+    fwrite(data, sample_size, RECORDING_LEN, fid);
+    fclose(fid);
+    free(data);
+
+    wlan_iqsource q = wlan_iqsource_create(_filename, _format);
+    float complex * y = (float complex*) malloc(BLOCK_LEN*sizeof(float complex));
+    while (wlan_iqsource_read(q, y, BLOCK_LEN) > 0);
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        wlan_iqsource_reset(q);
+        while (wlan_iqsource_read(q, y, BLOCK_LEN) > 0);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= RECORDING_LEN;
+
+    wlan_iqsource_destroy(q);
+    free(y);
+}
+
+int main() {
+    unsigned long int n;
+    struct rusage start, finish;
+
+    char filename[] = "/tmp/wlan_iqsource_benchmarkXXXXXX";
+    int fd = mkstemp(filename);
+    if (fd < 0) {
+        fprintf(stderr,"error: wlan_iqsource_benchmark, could not create temporary file\n");
+        exit(1);
+    }
+    close(fd);
+
+    const char * formats[3] = {"cf32", "ci16", "ci8"};
+    int format;
+    for (format=WLAN_IQ_CF32; format<=WLAN_IQ_CI8; format++) {
+        // run benchmark(s)
+        n = 16;
+        wlan_iqsource_benchmark(&start, &finish, &n, filename, format);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("wlan_iqsource (%-4s) : time : %8.5f s, iterations : %8lu (%8.2f MS/s)\n",
+                formats[format], extime, n, 1e-6f*(float)n/extime);
+    }
+
+    unlink(filename);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <sys/resource.h>
+#include "liquid-wlan.h"
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlanburstgen_benchmark(struct rusage *     _start,
+                            struct rusage *     _finish,
+                            unsigned long int * _num_iterations)
+{
+    unsigned long int i;
+
+    // mixed rates (9 M bits/s unsupported) and inter-frame gaps
+    unsigned int rates[7] = {WLANFRAME_RATE_6,  WLANFRAME_RATE_12, WLANFRAME_RATE_18,
+                             WLANFRAME_RATE_24, WLANFRAME_RATE_36, WLANFRAME_RATE_48,
+                             WLANFRAME_RATE_54};
+    unsigned int gaps[2] = {WLANFRAME_SIFS, WLANFRAME_DIFS};
+
+    // create burst generator and consumer buffer
+    wlanburstgen q = wlanburstgen_create(16, 16384);
+    float complex buffer[4096];
+
+    // sample counter
+    unsigned long int n = 0;
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        // schedule frame with random payload
+        struct wlan_txvector_s txvector;
+        txvector.LENGTH      = 100 + (i % 8)*200;
+        txvector.DATARATE    = rates[i % 7];
+        txvector.SERVICE     = 0;
+        txvector.TXPWR_LEVEL = 0;
+        while (wlanburstgen_push(q, NULL, txvector, gaps[i % 2])) {
+            // schedule full: run producer and drain ring buffer
+            wlanburstgen_execute(q);
+            n += wlanburstgen_read(q, buffer, 4096);
+        }
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    // set number of iterations to number of samples generated
+    *_num_iterations = n;
+
+    wlanburstgen_destroy(q);
+}
+
+int main() {
+    unsigned long int n = 40000;
+    struct rusage start, finish;
+
+    // run benchmark(s)
+    wlanburstgen_benchmark(&start, &finish, &n);
+
+    // compute execution time
+    float extime = calculate_execution_time(start, finish);
+
+    // print results
+    printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n", "wlanburstgen", extime, n, (float)n/extime);
+    
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapturesync_benchmark.c
+//
+// Capture decoding throughput (wall-clock time) for a recording of
+// back-to-back frames, with an increasing number of worker threads
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <liquid/liquid.h>
+#include "liquid-wlan.h"
+
+#define CAPTURE_LEN     (1<<22) // samples in capture
+#define CHUNK_LEN       (1<<18) // samples per chunk
+
+double calculate_execution_time(struct timeval _start, struct timeval _finish)
+{
+    return _finish.tv_sec - _start.tv_sec
+        + 1e-6*(_finish.tv_usec - _start.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlancapturesync_benchmark(struct timeval *    _start,
+                               struct timeval *    _finish,
+                               unsigned long int * _num_iterations,
+                               float complex *     _x,
+                               unsigned int        _num_workers)
+{
+    wlancapturesync q = wlancapturesync_create(_num_workers, CHUNK_LEN, 4095, NULL, NULL);
+
+    // start trials
+    gettimeofday(_start, NULL);
+    unsigned long int i;
+    for (i=0; i<(*_num_iterations); i++)
+        wlancapturesync_execute(q, _x, CAPTURE_LEN);
+    gettimeofday(_finish, NULL);
+    *_num_iterations *= CAPTURE_LEN;
+
+    wlancapturesync_destroy(q);
+}
+
+int main() {
+    // create capture: frames separated by short (SIFS) gaps, plus noise
+    float complex * x = (float complex*) malloc(CAPTURE_LEN*sizeof(float complex));
+
+    unsigned long int i;
+    for (i=0; i<CAPTURE_LEN; i++)
+        x[i] = 0.001f*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+
+    unsigned char payload[200];
+    for (i=0; i<200; i++)
+        payload[i] = rand() & 0xff;
+    struct wlan_txvector_s txvector = {200, WLANFRAME_RATE_6, 0, 0};
+
+    wlanframegen fg = wlanframegen_create();
+    float complex frame[8000];
+    unsigned int k = 0;
+    while (1) {
+        wlanframegen_assemble(fg, payload, txvector);
+        unsigned int m = wlanframegen_write_samples(fg, frame, 8000);
+        if (k + m + WLANFRAME_SIFS > CAPTURE_LEN)
+            break;
+        for (i=0; i<m; i++)
+            x[k+i] += frame[i];
+        k += m + WLANFRAME_SIFS;
+    }
+    wlanframegen_destroy(fg);
+
+    unsigned long int n;
+    struct timeval start, finish;
+
+    long int num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int num_workers;
+    for (num_workers=1; num_workers<=num_cores; num_workers*=2) {
+        // run benchmark(s)
+        n = 2;
+        wlancapturesync_benchmark(&start, &finish, &n, x, num_workers);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("wlancapturesync (%2u) : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n",
+                num_workers, extime, n, (float)n/extime);
+    }
+
+    free(x);
+    return 0;
+}
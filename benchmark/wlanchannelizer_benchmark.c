@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanchannelizer_benchmark.c
+//
+// Channelizer throughput (input samples) for an increasing number of
+// channels, without synchronizers attached
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <sys/resource.h>
+#include <liquid/liquid.h>
+#include "liquid-wlan.h"
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlanchannelizer_benchmark(struct rusage *     _start,
+                               struct rusage *     _finish,
+                               unsigned long int * _num_iterations,
+                               unsigned int        _num_channels)
+{
+    // create buffer of noise
+    unsigned int n = 8192;
+    float complex buffer[n];
+
+    unsigned long int i;
+    for (i=0; i<n; i++)
+        buffer[i] = ( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+
+    // create channelizer
+    wlanchannelizer q = wlanchannelizer_create(_num_channels);
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++)
+        wlanchannelizer_execute(q, buffer, n);
+    getrusage(RUSAGE_SELF, _finish);
+    *_num_iterations *= n;
+
+    wlanchannelizer_destroy(q);
+}
+
+int main() {
+    unsigned long int n;
+    struct rusage start, finish;
+
+    unsigned int num_channels;
+    for (num_channels=2; num_channels<=16; num_channels*=2) {
+        // run benchmark(s)
+        n = 400;
+        wlanchannelizer_benchmark(&start, &finish, &n, num_channels);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("wlanchannelizer (%2u) : time : %8.5f s, iterations : %8lu (%10.4e samples/s, %5.2f x real time)\n",
+                num_channels, extime, n, (float)n/extime, (float)n/extime/(20e6f*num_channels));
+    }
+    
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <sys/resource.h>
+#include "liquid-wlan.h"
+
+double calculate_execution_time(struct rusage _start, struct rusage _finish)
+{
+    return _finish.ru_utime.tv_sec - _start.ru_utime.tv_sec
+        + 1e-6*(_finish.ru_utime.tv_usec - _start.ru_utime.tv_usec)
+        + _finish.ru_stime.tv_sec - _start.ru_stime.tv_sec
+        + 1e-6*(_finish.ru_stime.tv_usec - _start.ru_stime.tv_usec);
+}
+
+// Helper function to keep code base small; repeatedly transmits a small
+// set of fixed (e.g. beacon) frames
+void wlanframecache_benchmark(struct rusage *     _start,
+                              struct rusage *     _finish,
+                              unsigned long int * _num_iterations,
+                              int                 _cache)
+{
+    unsigned long int i;
+
+    // fixed frames
+    unsigned char payload[4][300];
+    for (i=0; i<4*300; i++)
+        payload[i/300][i%300] = rand() & 0xff;
+    unsigned int rates[4] = {WLANFRAME_RATE_6, WLANFRAME_RATE_6, WLANFRAME_RATE_24, WLANFRAME_RATE_54};
+
+    // create frame generator and (optional) waveform cache
+    wlanframegen fg = wlanframegen_create();
+    wlanframecache cache = wlanframecache_create(1<<22);
+    if (_cache)
+        wlanframegen_set_cache(fg, cache);
+    float complex buffer[4096];
+
+    // sample counter
+    unsigned long int n = 0;
+
+    // start trials
+    getrusage(RUSAGE_SELF, _start);
+    for (i=0; i<(*_num_iterations); i++) {
+        struct wlan_txvector_s txvector;
+        txvector.LENGTH      = 300;
+        txvector.DATARATE    = rates[i % 4];
+        txvector.SERVICE     = 0;
+        txvector.TXPWR_LEVEL = 0;
+        wlanframegen_assemble(fg, payload[i % 4], txvector);
+
+        // generate frame
+        unsigned int k;
+        do {
+            k = wlanframegen_write_samples(fg, buffer, 4096);
+            n += k;
+        } while (k == 4096);
+    }
+    getrusage(RUSAGE_SELF, _finish);
+
+    // set number of iterations to number of samples generated
+    *_num_iterations = n;
+
+    if (_cache)
+        printf("cache hit rate : %.4f, %u bytes held\n",
+                wlanframecache_get_hit_rate(cache),
+                wlanframecache_get_num_bytes(cache));
+
+    wlanframegen_destroy(fg);
+    wlanframecache_destroy(cache);
+}
+
+int main() {
+    unsigned long int n;
+    struct rusage start, finish;
+    int cache;
+
+    for (cache=0; cache<2; cache++) {
+        // run benchmark(s)
+        n = 20000;
+        wlanframecache_benchmark(&start, &finish, &n, cache);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n",
+                cache ? "wlanframegen (cached)" : "wlanframegen", extime, n, (float)n/extime);
+    }
+    
+    return 0;
+}
@@ -90,19 +90,24 @@ void wlanframegen_benchmark(struct rusage *     _start,
 }
 
 int main() {
-    unsigned long int n = 40000;
     struct rusage start, finish;
-    unsigned int rate = WLANFRAME_RATE_6;
 
-    // run benchmark(s)
-    wlanframegen_benchmark(&start, &finish, &n, rate);
-
-    // compute execution time
-    float extime = calculate_execution_time(start, finish);
-
-    // print results
-    printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n", "wlanframegen", extime, n, (float)n/extime);
+    // run benchmark(s) across modulation depths
+    unsigned int rates[3] = {WLANFRAME_RATE_6, WLANFRAME_RATE_24, WLANFRAME_RATE_54};
+    const char * names[3] = {"wlanframegen (6 Mb/s)",
+                             "wlanframegen (24 Mb/s)",
+                             "wlanframegen (54 Mb/s)"};
+    unsigned int i;
+    for (i=0; i<3; i++) {
+        unsigned long int n = 40000;
+        wlanframegen_benchmark(&start, &finish, &n, rates[i]);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n", names[i], extime, n, (float)n/extime);
+    }
     
     return 0;
 }
-
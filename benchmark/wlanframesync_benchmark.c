@@ -35,13 +35,17 @@ double calculate_execution_time(struct rusage _start, struct rusage _finish)
 }
 
 // Helper function to keep code base small
+//  _traffic    :   input is back-to-back frames rather than noise
+//  _sc16       :   input is 16-bit integer samples
 void wlanframesync_benchmark(struct rusage *     _start,
                              struct rusage *     _finish,
                              unsigned long int * _num_iterations,
-                             unsigned int        _rate)
+                             unsigned int        _rate,
+                             int                 _traffic,
+                             int                 _sc16)
 {
     // create buffer (full of noise)
-    unsigned int n = 800;
+    unsigned int n = 8000;
     float complex buffer[n];
 
     unsigned long int i;
@@ -49,13 +53,45 @@ void wlanframesync_benchmark(struct rusage *     _start,
         buffer[i] = 0.001f*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
     }
 
+    if (_traffic) {
+        // fill buffer with frames separated by short (SIFS) gaps
+        unsigned char payload[200];
+        for (i=0; i<200; i++)
+            payload[i] = rand() & 0xff;
+        struct wlan_txvector_s txvector;
+        txvector.LENGTH      = 200;
+        txvector.DATARATE    = _rate;
+        txvector.SERVICE     = 0;
+        txvector.TXPWR_LEVEL = 0;
+
+        wlanframegen fg = wlanframegen_create();
+        float complex frame[n];
+        unsigned int k = 0;
+        while (k < n) {
+            wlanframegen_assemble(fg, payload, txvector);
+            unsigned int m = wlanframegen_write_samples(fg, frame, n);
+            if (k + m + WLANFRAME_SIFS > n)
+                break;
+            for (i=0; i<m; i++)
+                buffer[k+i] += frame[i];
+            k += m + WLANFRAME_SIFS;
+        }
+        wlanframegen_destroy(fg);
+    }
+
+    // quantize buffer (-12 dBFS full-scale headroom)
+    int16_t buffer_sc16[2*n];
+    for (i=0; i<2*n; i++)
+        buffer_sc16[i] = (int16_t)lrintf(8192.0f*((float*)buffer)[i]);
+
     // create frame synchronizer
     wlanframesync fs = wlanframesync_create(NULL, NULL);
 
     // start trials
     getrusage(RUSAGE_SELF, _start);
     for (i=0; i<(*_num_iterations); i++) {
-        wlanframesync_execute(fs, buffer, n);
+        if (_sc16) wlanframesync_execute_sc16(fs, buffer_sc16, n);
+        else       wlanframesync_execute(fs, buffer, n);
     }
     getrusage(RUSAGE_SELF, _finish);
     *_num_iterations *= n;
@@ -65,19 +101,27 @@ void wlanframesync_benchmark(struct rusage *     _start,
 }
 
 int main() {
-    unsigned long int n = 20000;
+    unsigned long int n;
     struct rusage start, finish;
     unsigned int rate = WLANFRAME_RATE_6;
+    int mode;
+    const char * names[4] = {"wlanframesync (idle)",      "wlanframesync (traffic)",
+                             "wlanframesync (idle/sc16)", "wlanframesync (traffic/sc16)"};
 
-    // run benchmark(s)
-    wlanframesync_benchmark(&start, &finish, &n, rate);
+    for (mode=0; mode<4; mode++) {
+        // run benchmark(s)
+        int traffic = mode & 1;
+        int sc16    = mode >> 1;
+        n = traffic ? 100 : 2000;
+        wlanframesync_benchmark(&start, &finish, &n, rate, traffic, sc16);
 
-    // compute execution time
-    float extime = calculate_execution_time(start, finish);
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
 
-    // print results
-    printf("%-24s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n", "wlanframesync", extime, n, (float)n/extime);
+        // print results
+        printf("%-28s : time : %8.5f s, iterations : %8lu (%10.4e samples/s)\n",
+                names[mode], extime, n, (float)n/extime);
+    }
     
     return 0;
 }
-
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanmultisync_benchmark.c
+//
+// Aggregate throughput of the multi-channel receiver (wall-clock time)
+// for a fixed number of channels carrying back-to-back frames, with an
+// increasing number of worker threads
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <liquid/liquid.h>
+#include "liquid-wlan.h"
+
+#define NUM_CHANNELS    (8)
+
+double calculate_execution_time(struct timeval _start, struct timeval _finish)
+{
+    return _finish.tv_sec - _start.tv_sec
+        + 1e-6*(_finish.tv_usec - _start.tv_usec);
+}
+
+// Helper function to keep code base small
+void wlanmultisync_benchmark(struct timeval *    _start,
+                             struct timeval *    _finish,
+                             unsigned long int * _num_iterations,
+                             unsigned int        _num_workers)
+{
+    // create buffer: frames separated by short (SIFS) gaps, plus noise
+    unsigned int n = 8000;
+    float complex buffer[n];
+
+    unsigned long int i;
+    for (i=0; i<n; i++)
+        buffer[i] = 0.001f*( randnf() + _Complex_I*randnf() )*M_SQRT1_2;
+
+    unsigned char payload[200];
+    for (i=0; i<200; i++)
+        payload[i] = rand() & 0xff;
+    struct wlan_txvector_s txvector = {200, WLANFRAME_RATE_6, 0, 0};
+
+    wlanframegen fg = wlanframegen_create();
+    float complex frame[n];
+    unsigned int k = 0;
+    while (k < n) {
+        wlanframegen_assemble(fg, payload, txvector);
+        unsigned int m = wlanframegen_write_samples(fg, frame, n);
+        if (k + m + WLANFRAME_SIFS > n)
+            break;
+        for (i=0; i<m; i++)
+            buffer[k+i] += frame[i];
+        k += m + WLANFRAME_SIFS;
+    }
+    wlanframegen_destroy(fg);
+
+    // create multi-channel receiver
+    wlanmultisync q = wlanmultisync_create(NUM_CHANNELS, _num_workers, 1<<16, NULL, NULL);
+    wlanmultisync_pin_workers(q);
+
+    // start trials: push buffer onto every channel, re-pushing what the
+    // queues cannot yet accept
+    gettimeofday(_start, NULL);
+    unsigned int c;
+    for (i=0; i<(*_num_iterations); i++) {
+        for (c=0; c<NUM_CHANNELS; c++) {
+            unsigned int j = 0;
+            while (j < n) {
+                unsigned int m = wlanmultisync_push(q, c, &buffer[j], n - j);
+                if (m == 0)
+                    usleep(100);    // queue full: let workers catch up
+                j += m;
+            }
+        }
+    }
+    wlanmultisync_wait(q);
+    gettimeofday(_finish, NULL);
+    *_num_iterations *= n * NUM_CHANNELS;
+
+    wlanmultisync_destroy(q);
+}
+
+int main() {
+    unsigned long int n;
+    struct timeval start, finish;
+
+    long int num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int num_workers;
+    for (num_workers=1; num_workers<=NUM_CHANNELS && num_workers<=num_cores; num_workers*=2) {
+        // run benchmark(s)
+        n = 100;
+        wlanmultisync_benchmark(&start, &finish, &n, num_workers);
+
+        // compute execution time
+        float extime = calculate_execution_time(start, finish);
+
+        // print results
+        printf("wlanmultisync (%u x %u) : time : %8.5f s, iterations : %8lu (%10.4e samples/s, %5.1f channels at 20 MS/s)\n",
+                NUM_CHANNELS, num_workers, extime, n, (float)n/extime, (float)n/extime/20e6f);
+    }
+    
+    return 0;
+}
@@ -47,6 +47,9 @@ extern const char liquid_wlan_version[];
 const char * liquid_wlan_libversion(void);
 int liquid_wlan_libversion_number(void);
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #   define LIQUID_WLAN_USE_COMPLEX_H 0
@@ -76,6 +79,86 @@ extern "C" {
 
 LIQUID_WLAN_DEFINE_COMPLEX(float,  liquid_float_complex);
 
+// 
+// 64-point transform backend
+//
+
+#define WLAN_FFT_BACKEND_LIQUID     (0) // liquid-dsp fft
+#define WLAN_FFT_BACKEND_FFTW       (1) // fftw (if available at build time)
+#define WLAN_FFT_BACKEND_BUILTIN    (2) // built-in fixed-size kernel
+
+// set transform backend for objects created afterwards (existing objects
+// keep theirs), returning '1' if the backend is not available. The
+// default is fftw if available, otherwise the built-in kernel.
+int wlan_fft_set_backend(int _backend);
+
+// get transform backend for objects created afterwards
+int wlan_fft_get_backend(void);
+
+// fftw planning effort; plans are shared process-wide, so each is only
+// planned once regardless of the number of objects
+#define WLAN_FFT_PLANNER_ESTIMATE   (0) // heuristic (fast startup)
+#define WLAN_FFT_PLANNER_MEASURE    (1) // measure candidate plans
+#define WLAN_FFT_PLANNER_PATIENT    (2) // measure more candidate plans
+
+// set fftw planning effort for plans created afterwards, returning '1'
+// if the value is invalid
+int wlan_fft_set_planner(int _planner);
+
+// get fftw planning effort for plans created afterwards
+int wlan_fft_get_planner(void);
+
+// import/export fftw wisdom from/to file, returning '1' on failure or if
+// fftw is not available
+int wlan_fft_import_wisdom(const char * _filename);
+int wlan_fft_export_wisdom(const char * _filename);
+
+// set fftw wisdom file, importing its wisdom now (returning '1' if it
+// could not be) and exporting to it whenever a new plan is measured, so
+// that measured plans persist across runs; NULL disables export
+int wlan_fft_set_wisdom_file(const char * _filename);
+
+// destroy cached plans, returning '1' if any object still uses them
+int wlan_fft_cache_clear(void);
+
+// 
+// object memory pool
+//
+
+// alignment required of memory passed to the *_init() methods [bytes]
+#define WLAN_MEMORY_ALIGN   (64)
+
+// forward declaration of object memory pool: a fixed number of equally-
+// sized blocks carved from a single aligned slab, e.g. holding the
+// synchronizers of a multi-channel receiver (see wlanframesync_sizeof(),
+// wlanframesync_init()). Allocation and release are thread-safe.
+typedef struct wlan_pool_s * wlan_pool;
+
+// create object memory pool
+//  _block_size :   minimum block size [bytes], rounded up to a multiple
+//                  of WLAN_MEMORY_ALIGN
+//  _num_blocks :   number of blocks
+wlan_pool wlan_pool_create(size_t       _block_size,
+                           unsigned int _num_blocks);
+
+// destroy object memory pool, releasing the slab (objects still placed
+// in the pool must have been finalized)
+void wlan_pool_destroy(wlan_pool _q);
+
+// print object memory pool internals
+void wlan_pool_print(wlan_pool _q);
+
+// allocate block (aligned to WLAN_MEMORY_ALIGN), returning NULL if the
+// pool is exhausted
+void * wlan_pool_alloc(wlan_pool _q);
+
+// return block to pool
+void wlan_pool_free(wlan_pool _q,
+                    void *    _block);
+
+// get number of available blocks
+unsigned int wlan_pool_get_num_free(wlan_pool _q);
+
 // rates
 #define WLANFRAME_RATE_6        (0) // BPSK,   r1/2, 1101
 #define WLANFRAME_RATE_9        (1) // BPSK,   r3/4, 1111
@@ -103,6 +186,35 @@ struct wlan_rxvector_s {
     unsigned int SERVICE;       // NULL: 7 scrambler initialization plus 9 reserved bits
 };
 
+// 
+// wlan assembled frame
+//
+
+// forward declaration of assembled (encoded) WLAN frame; assembling
+// distinct frame objects is thread-safe, so frames may be encoded on
+// worker threads and handed to a generator for modulation
+typedef struct wlanframe_s * wlanframe;
+
+// create assembled frame object
+wlanframe wlanframe_create();
+
+// destroy assembled frame object
+void wlanframe_destroy(wlanframe _f);
+
+// print assembled frame object internals
+void wlanframe_print(wlanframe _f);
+
+// assemble frame (see Table 76), returning '1' if rate is unsupported
+//  _f          :   frame object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+int wlanframe_assemble(wlanframe              _f,
+                       unsigned char *        _payload,
+                       struct wlan_txvector_s _txvector);
+
+// get number of samples in assembled frame
+unsigned int wlanframe_get_num_samples(wlanframe _f);
+
 // 
 // wlan frame generator
 //
@@ -116,19 +228,34 @@ wlanframegen wlanframegen_create();
 // destroy WLAN framing generator object
 void wlanframegen_destroy(wlanframegen _q);
 
+// placement initialization: a generator lives in a single block of
+// wlanframegen_sizeof() bytes aligned to WLAN_MEMORY_ALIGN (e.g. from a
+// wlan_pool); _fini() releases its resources but not the block itself
+size_t       wlanframegen_sizeof(void);
+wlanframegen wlanframegen_init(void * _mem);
+void         wlanframegen_fini(wlanframegen _q);
+
 // print WLAN framing generator object internals
 void wlanframegen_print(wlanframegen _q);
 
 // reset WLAN framing generator object internal state
 void wlanframegen_reset(wlanframegen _q);
 
-// assemble frame (see Table 76)
+// assemble frame (see Table 76), returning '-1' if the rate is
+// unsupported (9 M bits/s) and the frame was not loaded, '0' otherwise
 //  _q          :   framing object
 //  _payload    :   raw payload data [size: _opts.LENGTH x 1]
 //  _txvector   :   framing options
-void wlanframegen_assemble(wlanframegen           _q,
-                           unsigned char *        _payload,
-                           struct wlan_txvector_s _txvector);
+int wlanframegen_assemble(wlanframegen           _q,
+                          unsigned char *        _payload,
+                          struct wlan_txvector_s _txvector);
+
+// load assembled frame for modulation; frame is not copied and must not
+// be re-assembled or destroyed until the generator has completed it
+//  _q          :   framing generator object
+//  _frame      :   assembled frame
+void wlanframegen_load(wlanframegen _q,
+                       wlanframe    _frame);
 
 // write OFDM symbol, returning '1' when frame is complete
 //  _q          :   framing generator object
@@ -136,6 +263,134 @@ void wlanframegen_assemble(wlanframegen           _q,
 int wlanframegen_writesymbol(wlanframegen           _q,
                              liquid_float_complex * _buffer);
 
+// queue frame to be generated once the current frame completes; the
+// frame is assembled immediately (payload need not outlive the call).
+// Returns '1' if a frame is already queued, '-1' if the rate is
+// unsupported (9 M bits/s; the frame is dropped), '0' otherwise.
+//  _q          :   framing generator object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+int wlanframegen_queue(wlanframegen           _q,
+                       unsigned char *        _payload,
+                       struct wlan_txvector_s _txvector);
+
+// queue assembled frame to be loaded once the current frame completes,
+// returning '1' if a frame is already queued; frame is not copied
+//  _q          :   framing generator object
+//  _frame      :   assembled frame
+int wlanframegen_queue_frame(wlanframegen _q,
+                             wlanframe    _frame);
+
+// write arbitrary number of samples to buffer, spanning symbol and
+// frame boundaries and continuing into the queued frame, if any. Once
+// no frame remains the buffer is zero-padded. Returns the number of
+// frame (non-padding) samples written.
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   number of samples to write
+unsigned int wlanframegen_write_samples(wlanframegen           _q,
+                                        liquid_float_complex * _buffer,
+                                        unsigned int           _n);
+
+
+// 
+// wlan frame waveform cache
+//
+
+// forward declaration of WLAN frame waveform cache; rendered frames are
+// keyed by rate, scrambler seed and payload and evicted in least-
+// recently-used order once the memory budget is exceeded. A cache may
+// be shared by several generators on the same thread and must outlive
+// them.
+typedef struct wlanframecache_s * wlanframecache;
+
+// create WLAN frame waveform cache object
+//  _max_bytes  :   memory budget for cached frames [bytes]
+wlanframecache wlanframecache_create(unsigned int _max_bytes);
+
+// destroy WLAN frame waveform cache object
+void wlanframecache_destroy(wlanframecache _q);
+
+// print WLAN frame waveform cache object internals
+void wlanframecache_print(wlanframecache _q);
+
+// reset WLAN frame waveform cache, evicting all frames not in use and
+// clearing statistics
+void wlanframecache_reset(wlanframecache _q);
+
+// query methods
+float             wlanframecache_get_hit_rate(wlanframecache _q);
+unsigned long int wlanframecache_get_num_hits(wlanframecache _q);
+unsigned long int wlanframecache_get_num_lookups(wlanframecache _q);
+unsigned int      wlanframecache_get_num_bytes(wlanframecache _q);
+unsigned int      wlanframecache_get_num_entries(wlanframecache _q);
+
+// set waveform cache used by wlanframegen_assemble() and _queue(), or
+// NULL to disable; cached frames are replayed by copying samples
+//  _q          :   framing generator object
+//  _cache      :   frame waveform cache
+void wlanframegen_set_cache(wlanframegen   _q,
+                            wlanframecache _cache);
+
+// 
+// wlan burst generator
+//
+
+// inter-frame spacing [samples at 20 MHz]
+#define WLANFRAME_SIFS          (320)   // short inter-frame space, 16 us
+#define WLANFRAME_DIFS          (680)   // DCF inter-frame space, 34 us
+
+// forward declaration of WLAN burst generator; frames are scheduled and
+// generated on a producer thread (push, execute) and samples are read
+// from the lock-free ring buffer on a consumer thread (read)
+typedef struct wlanburstgen_s * wlanburstgen;
+
+// create WLAN burst generator object
+//  _num_entries    :   maximum number of scheduled frames
+//  _ring_len       :   ring buffer length (rounded up to power of 2)
+wlanburstgen wlanburstgen_create(unsigned int _num_entries,
+                                 unsigned int _ring_len);
+
+// destroy WLAN burst generator object
+void wlanburstgen_destroy(wlanburstgen _q);
+
+// print WLAN burst generator object internals
+void wlanburstgen_print(wlanburstgen _q);
+
+// reset WLAN burst generator, clearing schedule and ring buffer
+void wlanburstgen_reset(wlanburstgen _q);
+
+// (producer) schedule frame, returning '1' if schedule is full and '-1'
+// if the rate is unsupported (9 M bits/s)
+//  _q          :   burst generator object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1], or
+//                  NULL for random payload
+//  _txvector   :   framing options
+//  _gap        :   number of idle samples following the frame, e.g.
+//                  WLANFRAME_SIFS
+int wlanburstgen_push(wlanburstgen           _q,
+                      unsigned char *        _payload,
+                      struct wlan_txvector_s _txvector,
+                      unsigned int           _gap);
+
+// (producer) generate samples into ring buffer until full or schedule is
+// exhausted, returning number of samples written
+unsigned int wlanburstgen_execute(wlanburstgen _q);
+
+// (producer) query methods
+unsigned int      wlanburstgen_get_num_scheduled(wlanburstgen _q);
+unsigned long int wlanburstgen_get_num_frames(wlanburstgen _q);
+
+// (consumer) get number of samples available to read
+unsigned int wlanburstgen_get_num_available(wlanburstgen _q);
+
+// (consumer) read samples from ring buffer, returning number read
+//  _q          :   burst generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   maximum number of samples to read
+unsigned int wlanburstgen_read(wlanburstgen           _q,
+                               liquid_float_complex * _buffer,
+                               unsigned int           _n);
 
 // 
 // wlan frame synchronizer
@@ -163,6 +418,28 @@ wlanframesync wlanframesync_create(wlanframesync_callback _callback,
 // destroy WLAN framing synchronizer object
 void wlanframesync_destroy(wlanframesync _q);
 
+// placement initialization: a synchronizer lives in a single block of
+// wlanframesync_sizeof() bytes aligned to WLAN_MEMORY_ALIGN (e.g. from a
+// wlan_pool); _fini() releases its resources but not the block itself
+size_t        wlanframesync_sizeof(void);
+wlanframesync wlanframesync_init(void *                 _mem,
+                                 wlanframesync_callback _callback,
+                                 void *                 _userdata);
+void          wlanframesync_fini(wlanframesync _q);
+
+// create/size/initialize synchronizer accepting payloads up to
+// _max_length bytes (1-4095); message buffers are sized for this length
+// once so that receiving never allocates, and frames with a longer
+// LENGTH field are reported with an invalid header
+wlanframesync wlanframesync_create_max_length(wlanframesync_callback _callback,
+                                              void *                 _userdata,
+                                              unsigned int           _max_length);
+size_t        wlanframesync_sizeof_max_length(unsigned int _max_length);
+wlanframesync wlanframesync_init_max_length(void *                 _mem,
+                                            wlanframesync_callback _callback,
+                                            void *                 _userdata,
+                                            unsigned int           _max_length);
+
 // print WLAN framing synchronizer object internals
 void wlanframesync_print(wlanframesync _q);
 
@@ -177,9 +454,298 @@ void wlanframesync_execute(wlanframesync          _q,
                            liquid_float_complex * _buffer,
                            unsigned int           _n);
 
+// execute framing synchronizer on interleaved I/Q integer samples (full
+// scale 32768 and 128, respectively) without converting them to a float
+// buffer first; the scale only affects reported levels (e.g. RSSI).
+// Switching between execute methods is supported between frames.
+//  _q      :   framing synchronizer object
+//  _buffer :   input buffer [size: 2*_n x 1]
+//  _n      :   number of complex samples
+void wlanframesync_execute_sc16(wlanframesync   _q,
+                                const int16_t * _buffer,
+                                unsigned int    _n);
+void wlanframesync_execute_sc8(wlanframesync  _q,
+                               const int8_t * _buffer,
+                               unsigned int   _n);
+
 // query methods
 float wlanframesync_get_rssi(wlanframesync _q); // received signal strength indication
 float wlanframesync_get_cfo(wlanframesync _q);  // carrier offset estimate
+float wlanframesync_get_noise_floor(wlanframesync _q);  // noise floor estimate [dB]
+float wlanframesync_get_threshold(wlanframesync _q);    // S0[a] detection threshold
+
+// detection statistics
+unsigned long int wlanframesync_get_num_detections(wlanframesync _q);
+unsigned long int wlanframesync_get_num_s1_timeouts(wlanframesync _q);
+unsigned long int wlanframesync_get_num_signal_errors(wlanframesync _q);
+
+// get number of input samples processed since the object was created
+// (not cleared by wlanframesync_reset()); samples consumed but still
+// buffered behind the symbol being processed are not counted, so within
+// a callback this is the position just past the last sample of the frame
+unsigned long int wlanframesync_get_num_samples(wlanframesync _q);
+
+// set target false-alarm rate (detections per 64-sample search window
+// that time out on S1 or fail the SIGNAL parity check); the detection
+// threshold adapts to this rate, and a value of zero holds it fixed
+void wlanframesync_set_false_alarm_rate(wlanframesync _q,
+                                        float         _pfa);
+
+// 
+// wlan IQ recording source
+//
+
+// sample formats (interleaved I/Q, native byte order)
+#define WLAN_IQ_CF32            (0) // 32-bit float
+#define WLAN_IQ_CI16            (1) // 16-bit signed integer
+#define WLAN_IQ_CI8             (2) // 8-bit signed integer
+
+// forward declaration of IQ recording source: maps a raw recording (or
+// SigMF recording) read-only and converts it to scaled complex float in
+// blocks directly from the mapping
+typedef struct wlan_iqsource_s * wlan_iqsource;
+
+// create IQ source from raw recording
+//  _filename   :   recording file name
+//  _format     :   sample format (WLAN_IQ_CF32, WLAN_IQ_CI16, WLAN_IQ_CI8)
+wlan_iqsource wlan_iqsource_create(const char * _filename,
+                                   int          _format);
+
+// create IQ source from SigMF recording; the format (cf32_le, ci16_le or
+// ci8) and sample rate are read from the metadata file
+//  _filename   :   recording base name, or name of its .sigmf-meta or
+//                  .sigmf-data file
+wlan_iqsource wlan_iqsource_create_sigmf(const char * _filename);
+
+// destroy IQ source, unmapping recording
+void wlan_iqsource_destroy(wlan_iqsource _q);
+
+// print IQ source internals
+void wlan_iqsource_print(wlan_iqsource _q);
+
+// rewind IQ source to start of recording
+void wlan_iqsource_reset(wlan_iqsource _q);
+
+// set conversion scale (default: unity for cf32, 1/32768 for ci16 and
+// 1/128 for ci8)
+void wlan_iqsource_set_scale(wlan_iqsource _q,
+                             float         _scale);
+
+// query methods
+unsigned long int wlan_iqsource_get_num_samples(wlan_iqsource _q);   // samples in recording
+unsigned long int wlan_iqsource_get_num_remaining(wlan_iqsource _q); // samples not yet read
+float             wlan_iqsource_get_sample_rate(wlan_iqsource _q);   // from metadata [Hz], 0 if unknown
+
+// read samples, returning number of samples read (short at end of
+// recording)
+//  _q      :   IQ source object
+//  _y      :   output samples [size: _n x 1]
+//  _n      :   maximum number of samples to read
+unsigned int wlan_iqsource_read(wlan_iqsource          _q,
+                                liquid_float_complex * _y,
+                                unsigned int           _n);
+
+// run synchronizer over samples, returning number of samples consumed
+// (short at end of recording)
+//  _q      :   IQ source object
+//  _fs     :   frame synchronizer
+//  _n      :   maximum number of samples to consume
+unsigned long int wlan_iqsource_execute(wlan_iqsource     _q,
+                                        wlanframesync     _fs,
+                                        unsigned long int _n);
+
+// 
+// wlan multi-channel receiver
+//
+
+// forward declaration of WLAN multi-channel receiver: one frame
+// synchronizer per channel, each fed by its own sample queue (single
+// producer per channel) and run on a pool of worker threads. Channels
+// with queued samples are scheduled onto per-worker run queues; idle
+// workers steal from busy ones.
+typedef struct wlanmultisync_s * wlanmultisync;
+
+// callback function, invoked from worker threads (never concurrently
+// for the same channel)
+//  _channel        : channel id
+//  _header_valid   : flag indicating if header is valid
+//  _payload        : received payload (NULL if header isn't valid)
+//  _rxvector       : received vector (see Table 77)
+//  _userdata       : user-defined data object
+typedef int (*wlanmultisync_callback)(unsigned int           _channel,
+                                      int                    _header_valid,
+                                      unsigned char *        _payload,
+                                      struct wlan_rxvector_s _rxvector,
+                                      void *                 _userdata);
+
+// create multi-channel receiver object, starting worker threads
+//  _num_channels   :   number of channels
+//  _num_workers    :   number of worker threads
+//  _queue_len      :   per-channel sample queue length (rounded up to
+//                      power of 2)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanmultisync wlanmultisync_create(unsigned int           _num_channels,
+                                   unsigned int           _num_workers,
+                                   unsigned int           _queue_len,
+                                   wlanmultisync_callback _callback,
+                                   void *                 _userdata);
+
+// destroy multi-channel receiver object, stopping worker threads;
+// samples not yet processed are discarded (see wlanmultisync_wait())
+void wlanmultisync_destroy(wlanmultisync _q);
+
+// print multi-channel receiver object internals (per-channel statistics)
+void wlanmultisync_print(wlanmultisync _q);
+
+// pin worker threads to cores (worker i to core i modulo the number of
+// online cores), returning '1' if not supported on this platform
+int wlanmultisync_pin_workers(wlanmultisync _q);
+
+// push samples onto channel queue, returning the number of samples
+// accepted. Samples are never dropped silently: those not accepted
+// (queue full) are counted as overflows and may be pushed again.
+//  _q          :   multi-channel receiver object
+//  _channel    :   channel id
+//  _buffer     :   input samples [size: _n x 1]
+//  _n          :   number of samples
+unsigned int wlanmultisync_push(wlanmultisync          _q,
+                                unsigned int           _channel,
+                                liquid_float_complex * _buffer,
+                                unsigned int           _n);
+
+// wait until all samples pushed so far have been processed
+void wlanmultisync_wait(wlanmultisync _q);
+
+// get number of channels
+unsigned int wlanmultisync_get_num_channels(wlanmultisync _q);
+
+// per-channel statistics: samples queued but not yet processed, backlog
+// high-water mark, samples rejected by wlanmultisync_push(), and frames
+// received with a valid header
+unsigned int      wlanmultisync_get_backlog(wlanmultisync _q, unsigned int _channel);
+unsigned int      wlanmultisync_get_max_backlog(wlanmultisync _q, unsigned int _channel);
+unsigned long int wlanmultisync_get_num_overflows(wlanmultisync _q, unsigned int _channel);
+unsigned long int wlanmultisync_get_num_frames(wlanmultisync _q, unsigned int _channel);
+
+// 
+// wlan capture decoder
+//
+
+// forward declaration of WLAN capture decoder: decodes a complete
+// recording by splitting it into chunks, each run through its own frame
+// synchronizer on a pool of worker threads. Chunks are preceded by an
+// overlap of two maximum-length frames so that each synchronizer settles
+// and completes any frame straddling the chunk boundary; frames found by
+// two chunks are reported once, matching a serial decode.
+typedef struct wlancapturesync_s * wlancapturesync;
+
+// callback function, invoked from the thread calling
+// wlancapturesync_execute() with frames in capture order
+//  _index          : capture sample index just past the end of the frame
+//  _header_valid   : flag indicating if header is valid
+//  _payload        : received payload (NULL if header isn't valid)
+//  _rxvector       : received vector (see Table 77)
+//  _userdata       : user-defined data object
+typedef int (*wlancapturesync_callback)(unsigned long int      _index,
+                                        int                    _header_valid,
+                                        unsigned char *        _payload,
+                                        struct wlan_rxvector_s _rxvector,
+                                        void *                 _userdata);
+
+// create capture decoder object
+//  _num_workers    :   number of worker threads
+//  _chunk_len      :   samples per chunk, excluding overlap (should be
+//                      large compared to wlancapturesync_get_overlap())
+//  _max_length     :   maximum payload length (1-4095); longer frames
+//                      are reported with an invalid header
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlancapturesync wlancapturesync_create(unsigned int             _num_workers,
+                                       unsigned int             _chunk_len,
+                                       unsigned int             _max_length,
+                                       wlancapturesync_callback _callback,
+                                       void *                   _userdata);
+
+// destroy capture decoder object
+void wlancapturesync_destroy(wlancapturesync _q);
+
+// print capture decoder object internals
+void wlancapturesync_print(wlancapturesync _q);
+
+// get number of samples run ahead of each chunk
+unsigned int wlancapturesync_get_overlap(wlancapturesync _q);
+
+// get number of frames found by two neighbouring chunks (and reported
+// once) during the last call to wlancapturesync_execute()
+unsigned long int wlancapturesync_get_num_duplicates(wlancapturesync _q);
+
+// decode capture (sample indices start at zero on each call), returning
+// the number of frames reported
+//  _q      :   capture decoder object
+//  _x      :   capture [size: _n x 1]
+//  _n      :   number of samples in capture
+unsigned long int wlancapturesync_execute(wlancapturesync        _q,
+                                          liquid_float_complex * _x,
+                                          unsigned long int      _n);
+
+// 
+// wlan channelizer
+//
+
+// forward declaration of WLAN channelizer: polyphase filterbank which
+// splits a wideband capture at M x 20 MS/s into M channels at 20 MS/s
+// on a 20 MHz grid, with one M-point transform per M input samples.
+// Channel k is centered k x 20 MHz from the capture center for k < M/2
+// and (k-M) x 20 MHz otherwise.
+typedef struct wlanchannelizer_s * wlanchannelizer;
+
+// create channelizer object
+//  _num_channels   :   number of channels, M (at least 2)
+wlanchannelizer wlanchannelizer_create(unsigned int _num_channels);
+
+// destroy channelizer object (synchronizers/receiver are not destroyed)
+void wlanchannelizer_destroy(wlanchannelizer _q);
+
+// print channelizer object internals
+void wlanchannelizer_print(wlanchannelizer _q);
+
+// reset channelizer object, clearing filter state
+void wlanchannelizer_reset(wlanchannelizer _q);
+
+// get channel center offset from capture center in units of 20 MHz
+int wlanchannelizer_get_channel_offset(wlanchannelizer _q,
+                                       unsigned int    _channel);
+
+// set frame synchronizer receiving channel output, run in the caller's
+// thread from wlanchannelizer_execute() (NULL to disable)
+void wlanchannelizer_set_sync(wlanchannelizer _q,
+                              unsigned int    _channel,
+                              wlanframesync   _fs);
+
+// set multi-channel receiver receiving all channel outputs, channel k
+// pushed to receiver channel k (NULL to disable). Outputs the receiver
+// cannot accept are counted as its overflows and not retried.
+void wlanchannelizer_set_multisync(wlanchannelizer _q,
+                                   wlanmultisync   _ms);
+
+// channelize one block of M input samples into one output sample per
+// channel (not handed to synchronizers/receiver)
+//  _q      :   channelizer object
+//  _x      :   input samples [size: M x 1]
+//  _y      :   channel outputs [size: M x 1]
+void wlanchannelizer_execute_block(wlanchannelizer        _q,
+                                   liquid_float_complex * _x,
+                                   liquid_float_complex * _y);
+
+// channelize arbitrary number of input samples (partial blocks are
+// retained across calls), handing outputs to the synchronizers/receiver
+//  _q      :   channelizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void wlanchannelizer_execute(wlanchannelizer        _q,
+                             liquid_float_complex * _x,
+                             unsigned int           _n);
 
 // 
 // internal/debugging methods
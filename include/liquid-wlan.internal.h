@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include <complex.h>
+#include <stdint.h>
 #include <liquid/liquid.h>
 
 #include "liquid-wlan.h"
@@ -42,6 +43,25 @@ extern const unsigned char liquid_wlan_parity[256];
 unsigned int liquid_wlan_bdotprod(unsigned int _x,
                                   unsigned int _y);
 
+// scale/convert interleaved values to float, vectorized over groups of
+// 16 complex samples
+//  _x      :   input values [size: _n x 1]
+//  _n      :   number of real values (twice the number of samples)
+//  _g      :   scale
+//  _y      :   output values [size: _n x 1]
+void liquid_wlan_convert_cf32(const float * restrict _x,
+                              unsigned int           _n,
+                              float                  _g,
+                              float * restrict       _y);
+void liquid_wlan_convert_ci16(const int16_t * restrict _x,
+                              unsigned int             _n,
+                              float                    _g,
+                              float * restrict         _y);
+void liquid_wlan_convert_ci8(const int8_t * restrict _x,
+                             unsigned int            _n,
+                             float                   _g,
+                             float * restrict        _y);
+
 // repack bytes with arbitrary symbol sizes
 //  _sym_in             :   input symbols array [size: _sym_in_len x 1]
 //  _sym_in_bps         :   number of bits per input symbol
@@ -58,27 +78,98 @@ void liquid_wlan_repack_bytes(unsigned char * _sym_in,
                               unsigned int    _sym_out_len,
                               unsigned int *  _num_written);
 
-// Use fftw library if installed, otherwise use liquid-dsp (less
-// efficient) fft library.
+// round object size up to a multiple of WLAN_MEMORY_ALIGN so that
+// objects placed consecutively in a block stay aligned
+#define WLAN_ALIGN_SIZE(n) \
+    (((size_t)(n) + WLAN_MEMORY_ALIGN - 1) & ~((size_t)WLAN_MEMORY_ALIGN - 1))
+
+//
+// 64-point transform
+//
+
+// fftw backend is available if installed; liquid-dsp (less efficient)
+// and the built-in kernel are always available
 #if HAVE_FFTW3_H
 #   include <fftw3.h>
-#   define FFT_PLAN             fftwf_plan
-#   define FFT_CREATE_PLAN      fftwf_plan_dft_1d
-#   define FFT_DESTROY_PLAN     fftwf_destroy_plan
-#   define FFT_EXECUTE          fftwf_execute
-#   define FFT_DIR_FORWARD      FFTW_FORWARD
-#   define FFT_DIR_BACKWARD     FFTW_BACKWARD
-#   define FFT_METHOD           FFTW_ESTIMATE
-#else
-#   define FFT_PLAN             fftplan
-#   define FFT_CREATE_PLAN      fft_create_plan
-#   define FFT_DESTROY_PLAN     fft_destroy_plan
-#   define FFT_EXECUTE          fft_execute
-#   define FFT_DIR_FORWARD      FFT_FORWARD
-#   define FFT_DIR_BACKWARD     FFT_REVERSE
-#   define FFT_METHOD           0
 #endif
 
+// transform direction
+#define WLAN_FFT_FORWARD        (-1)
+#define WLAN_FFT_BACKWARD       ( 1)
+
+// transform options
+#define WLAN_FFT_FLAG_NULLS     (1<<0)  // input NULL subcarriers are zero
+
+typedef struct wlan_fft_s * wlan_fft;
+
+// create 64-point transform object with bound arrays, using the backend
+// selected with wlan_fft_set_backend()
+//  _x          :   input array [size: 64 x 1]
+//  _y          :   output array [size: 64 x 1]
+//  _direction  :   WLAN_FFT_FORWARD or WLAN_FFT_BACKWARD
+//  _flags      :   WLAN_FFT_FLAG_* options
+wlan_fft wlan_fft_create(float complex * _x,
+                         float complex * _y,
+                         int             _direction,
+                         int             _flags);
+
+// destroy transform object (shared plans remain cached)
+void wlan_fft_destroy(wlan_fft _q);
+
+// placement initialization: get object size [bytes], initialize object
+// in caller-provided memory, and release its resources (the liquid-dsp
+// backend allocates its own plan) without freeing the memory
+size_t   wlan_fft_sizeof(void);
+wlan_fft wlan_fft_init(void *          _mem,
+                       float complex * _x,
+                       float complex * _y,
+                       int             _direction,
+                       int             _flags);
+void     wlan_fft_fini(wlan_fft _q);
+
+// get backend used by transform object
+int wlan_fft_get_object_backend(wlan_fft _q);
+
+// execute transform on bound arrays
+void wlan_fft_execute(wlan_fft _q);
+
+// execute transform on new arrays (which may be the same)
+void wlan_fft_execute_dft(wlan_fft        _q,
+                          float complex * _x,
+                          float complex * _y);
+
+// built-in 64-point transform plan: twiddle factors, split real/imag
+struct wlan_fft64_plan_s {
+    float sign;             // -1 (forward), +1 (backward)
+    float w16_re[16];       // W16^(r*q), [r*4 + q], r,q in [0,3]
+    float w16_im[16];
+    float w64_re[64];       // W64^(r*q), [r*16 + q], r in [0,3], q in [0,15]
+    float w64_im[64];
+};
+
+// get shared built-in plan for direction (cache lock must be held)
+struct wlan_fft64_plan_s * wlan_fft_cache_builtin(int _direction);
+
+#if HAVE_FFTW3_H
+// get shared fftw plan for direction and array alignment at the current
+// planner effort (cache lock must be held)
+fftwf_plan wlan_fft_cache_fftw(int _direction,
+                               int _unaligned);
+#endif
+
+// built-in 64-point transform (three radix-4 stages)
+void wlan_fft64_execute(struct wlan_fft64_plan_s * _p,
+                        int                        _flags,
+                        float complex *            _x,
+                        float complex *            _y);
+
+// built-in transform, first stage for input with zero-valued NULL
+// subcarriers
+void wlan_fft64_stage1_nulls(const float * _x,
+                             float         _s,
+                             float *       _ar,
+                             float *       _ai);
+
 //
 // wi-fi frame (common objects)
 //
@@ -158,6 +249,12 @@ wlan_lfsr wlan_lfsr_create(unsigned int _m,
                            unsigned int _g,
                            unsigned int _a);
 
+// initialize object in place (e.g. embedded in another object)
+void wlan_lfsr_init(wlan_lfsr    _ms,
+                    unsigned int _m,
+                    unsigned int _g,
+                    unsigned int _a);
+
 // destroy an wlan_lfsr object, freeing all internal memory
 void wlan_lfsr_destroy(wlan_lfsr _m);
 
@@ -263,10 +360,12 @@ void wlan_fec_encode(unsigned int    _fec_scheme,
 // decode data using convolutional code
 //  _fec_scheme :   error-correction scheme
 //  _dec_msg_len:   length of decoded message
+//  _tail_index :   bit index of the six (zero) tail bits in decoded message
 //  _msg_enc    :   encoded message
 //  _msg_dec    :   decoded message (with tail bits inserted)
 void wlan_fec_decode(unsigned int    _fec_scheme,
                      unsigned int    _dec_msg_len,
+                     unsigned int    _tail_index,
                      unsigned char * _msg_enc,
                      unsigned char * _msg_dec);
 
@@ -320,6 +419,15 @@ extern struct wlan_interleaver_tab_s wlan_intlv_R54[288];
 // indexable table of above structured auto-generated tables
 extern struct wlan_interleaver_tab_s * wlan_intlv_gentab[8];
 
+// external auto-generated least-squares polynomial fit tables for the
+// equalizer (see liquid-wlan/src/gentab), [size: (order+1) x 52]
+extern const float wlan_eqfit_P1[104];
+extern const float wlan_eqfit_P2[156];
+extern const float wlan_eqfit_P3[208];
+
+// indexable table of above fit tables (by polynomial order)
+extern const float * wlan_eqfit_gentab[4];
+
 // intereleave one OFDM symbol
 //  _rate       :   primitive rate
 //  _msg_dec    :   decoded message (de-iterleaved)
@@ -404,6 +512,86 @@ extern const float complex wlanframe_s1[64]; // time
 #define WLANFRAME_SCTYPE_PILOT  1
 #define WLANFRAME_SCTYPE_DATA   2
 
+// DATA subcarrier indices in modulation order
+extern const unsigned char wlanframe_sc_data[48];
+
+//
+// wi-fi assembled frame
+//
+
+// assembled frame; read-only once assembled, so a single frame may be
+// loaded into any number of generators
+struct wlanframe_s {
+    // options
+    unsigned int rate;      // primitive data rate
+    unsigned int length;    // original data length (bytes)
+    unsigned int seed;      // data scrambler seed
+    unsigned int mod_scheme;// DATA field modulation scheme
+
+    // lengths
+    unsigned int ndbps;             // number of data bits per OFDM symbol
+    unsigned int ncbps;             // number of coded bits per OFDM symbol
+    unsigned int nbpsc;             // number of bits per subcarrier (modulation depth)
+    unsigned int dec_msg_len;       // length of decoded message (bytes)
+    unsigned int enc_msg_len;       // length of encoded message (bytes)
+    unsigned int enc_msg_max;       // allocated length of encoded message (bytes)
+    unsigned int nsym;              // number of OFDM symbols in the DATA field
+    unsigned int ndata;             // number of bits in the DATA field
+    unsigned int npad;              // number of pad bits
+    unsigned int bytes_per_symbol;  // number of encoded data bytes per OFDM symbol
+
+    // data arrays
+    unsigned char   signal_dec[3];  // decoded message (SIGNAL field)
+    unsigned char   signal_enc[6];  // encoded message (SIGNAL field)
+    unsigned char   signal_int[6];  // interleaved message (SIGNAL field)
+    unsigned char * msg_enc;        // encoded message (DATA field)
+
+    int assembled;                  // frame assembled flag
+};
+
+// placement initialization (see wlanframe_create()); the encoded message
+// array is held in the same block, following the object
+size_t    wlanframe_sizeof(void);
+wlanframe wlanframe_init(void * _mem);
+void      wlanframe_fini(wlanframe _f);
+
+//
+// wi-fi frame waveform cache
+//
+
+// cached frame waveform
+struct wlanframecache_entry_s {
+    // key
+    unsigned int rate;              // primitive data rate
+    unsigned int seed;              // data scrambler seed
+    unsigned int length;            // payload length (bytes)
+    unsigned int hash;              // payload hash
+    unsigned char * payload;        // payload copy (resolves collisions)
+
+    // rendered frame
+    float complex * samples;        // frame waveform
+    unsigned int num_samples;       // number of samples in waveform
+
+    unsigned int num_users;         // number of generators using entry
+    struct wlanframecache_entry_s * hash_next;  // next entry in chain
+    struct wlanframecache_entry_s * lru_prev;   // more recently used
+    struct wlanframecache_entry_s * lru_next;   // less recently used
+};
+
+// look up frame waveform, rendering and inserting it on a miss; returns
+// entry marked in use, or NULL if the frame does not fit in the cache.
+// The unsupported 9 M bits/s rate is rejected (callers check first).
+//  _q          :   frame cache object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+struct wlanframecache_entry_s * wlanframecache_acquire(wlanframecache         _q,
+                                                      unsigned char *        _payload,
+                                                      struct wlan_txvector_s _txvector);
+
+// release entry acquired with wlanframecache_acquire()
+void wlanframecache_release(wlanframecache                  _q,
+                            struct wlanframecache_entry_s * _e);
+
 //
 // wi-fi frame generator (internal methods)
 //
@@ -426,6 +614,12 @@ void wlanframegen_gensymbol(float complex * _x,
                             unsigned int    _p,
                             float complex * _symbol);
 
+// load cached waveform for replay
+//  _q          :   framing generator object
+//  _e          :   cache entry, acquired by caller
+void wlanframegen_load_entry(wlanframegen                    _q,
+                             struct wlanframecache_entry_s * _e);
+
 void wlanframegen_writesymbol_S0a(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_S0b(wlanframegen _q, float complex * _buffer);
 void wlanframegen_writesymbol_S1a(wlanframegen _q, float complex * _buffer);
@@ -438,6 +632,20 @@ void wlanframegen_writesymbol_null(wlanframegen _q, float complex * _buffer);
 // wi-fi frame synchronizer (internal methods)
 //
 
+// execute synchronizer on input buffer of given sample format
+// (WLAN_IQ_CF32, WLAN_IQ_CI16 or WLAN_IQ_CI8), _n complex samples
+void wlanframesync_execute_format(wlanframesync _q,
+                                  const void *  _buffer,
+                                  int           _format,
+                                  unsigned int  _n);
+
+// set input sample unit relative to full scale, rescaling the gain,
+// noise floor and buffered samples if it changes
+void wlanframesync_set_sample_scale(wlanframesync _q,
+                                    float         _scale);
+
+// state handlers, invoked by wlanframesync_execute_format() once the state's
+// symbol period of samples has been written to the input buffer
 void wlanframesync_execute_seekplcp(wlanframesync _q);
 void wlanframesync_execute_rxshort0(wlanframesync _q);
 void wlanframesync_execute_rxshort1(wlanframesync _q);
@@ -446,6 +654,57 @@ void wlanframesync_execute_rxlong1(wlanframesync _q);
 void wlanframesync_execute_rxsignal(wlanframesync _q);
 void wlanframesync_execute_rxdata(wlanframesync _q);
 
+// advance carrier oscillator phase by _n samples, wrapping it to [-pi,pi]
+void wlanframesync_nco_step(wlanframesync _q,
+                            unsigned int  _n);
+
+// run forward transform on 64 samples at _x, storing the result in _q->X
+void wlanframesync_fft(wlanframesync   _q,
+                       float complex * _x);
+
+// correct carrier frequency offset on samples _j through _j+_n-1 of the
+// symbol being processed (rc[_j], ...), which ends _q->delay samples
+// before the end of the input buffer, derotating by the oscillator's
+// phase ramp; the oscillator phase corresponds to the next sample to be
+// written, i.e. rc[80+delay]
+//  _q      :   framing synchronizer object
+//  _j      :   index of first sample in symbol, _j+_n <= 80
+//  _n      :   number of samples (multiple of 4)
+//  _y      :   output array [size: _n x 1]
+void wlanframesync_mix_down(wlanframesync   _q,
+                            unsigned int    _j,
+                            unsigned int    _n,
+                            float complex * _y);
+
+// derotate block by phase ramp, y[i] = x[i] exp(-j(theta + i*dtheta))
+//  _x      :   input array [size: _n x 1]
+//  _n      :   number of samples (multiple of 4)
+//  _theta  :   phase of first sample
+//  _dtheta :   phase step per sample
+//  _y      :   output array [size: _n x 1]
+void wlanframesync_derotate(float complex * _x,
+                            unsigned int    _n,
+                            float           _theta,
+                            float           _dtheta,
+                            float complex * _y);
+
+// apply gain and derotate block by phase ramp,
+// y[i] = x[i] g[i] exp(-j(theta + i*dtheta))
+//  _x      :   input array [size: _n x 1]
+//  _g_re   :   gain array (real) [size: _n x 1]
+//  _g_im   :   gain array (imag) [size: _n x 1]
+//  _n      :   number of samples (multiple of 4)
+//  _theta  :   phase of first sample
+//  _dtheta :   phase step per sample
+//  _y      :   output array [size: _n x 1], may alias _x
+void wlanframesync_derotate_gain(float complex * _x,
+                                 float *         _g_re,
+                                 float *         _g_im,
+                                 unsigned int    _n,
+                                 float           _theta,
+                                 float           _dtheta,
+                                 float complex * _y);
+
 // estimate short sequence gain
 //  _q      :   wlanframesync object
 //  _x      :   input array (time), [size: M x 1]
@@ -454,6 +713,24 @@ void wlanframesync_estimate_gain_S0(wlanframesync _q,
                                     float complex * _x,
                                     float complex * _G);
 
+// compute every fourth bin of 64-point forward transform by folding input
+// into 16 samples and running 16-point transform, Y[k] = X[4k]
+//  _x      :   input array (time), [size: 64 x 1]
+//  _Y      :   output array (freq), [size: 16 x 1]
+void wlanframesync_fft16_folded(float complex * _x,
+                                float complex * _Y);
+
+// compute delay-and-correlate (Schmidl-Cox) metric at lag 16 over
+// window, normalized by energy of the delayed samples
+//  _x      :   input array (time), [size: 64 x 1]
+//  _e      :   output energy of the delayed samples (48 samples)
+float wlanframesync_S0_autocorr(float complex * _x,
+                                float *         _e);
+
+// update detection threshold after a false alarm (S1 time-out or invalid
+// SIGNAL field)
+void wlanframesync_false_alarm(wlanframesync _q);
+
 // compute S0 metrics
 void wlanframesync_S0_metrics(wlanframesync _q,
                               float complex * _G,
@@ -471,6 +748,11 @@ void wlanframesync_estimate_gain_S1(wlanframesync _q,
                                     float complex * _x,
                                     float complex * _G);
 
+// compute normalized cross-correlation of input against long sequence
+// (time domain), near unity only when aligned with S1[a] or S1[b]
+//  _x      :   input array (time), [size: 64 x 1]
+float wlanframesync_S1_xcorr(float complex * _x);
+
 // compute S1 metrics
 void wlanframesync_S1_metrics(wlanframesync _q,
                               float complex * _G,
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_eqfit_gentab.c
+//
+// generate least-squares polynomial fit table for the equalizer; the
+// 52 non-null subcarrier frequencies are fixed, so the pseudo-inverse
+// P = (A^T A)^-1 A^T of the Vandermonde matrix A can be computed once
+// and the fit reduces to a matrix-vector product p = P y
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+void usage()
+{
+    printf("Usage: wlan_eqfit_gentab [OPTION]\n");
+    printf("  h     : print help\n");
+    printf("  o     : polynomial order {1,2,3}\n");
+}
+
+int main(int argc, char*argv[])
+{
+    // option(s)
+    unsigned int order = 2;     // polynomial order
+
+    // get options
+    int dopt;
+    while((dopt = getopt(argc,argv,"ho:")) != EOF){
+        switch (dopt) {
+        case 'h':
+            usage();
+            return 0;
+        case 'o':
+            order = atoi(optarg);
+            if (order < 1 || order > 3) {
+                fprintf(stderr,"error: %s, invalid order '%s'\n", argv[0], optarg);
+                exit(1);
+            }
+            break;
+        default:
+            exit(1);
+        }
+    }
+
+    unsigned int m = order + 1; // number of coefficients
+    unsigned int i;
+    unsigned int j;
+    unsigned int n;
+
+    // Vandermonde matrix on non-null subcarriers, ascending
+    // frequency: -26,...,-1,1,...,26 (normalized by 64)
+    double A[52][4];
+    n = 0;
+    int k;
+    for (k=-26; k<=26; k++) {
+        if (k == 0) continue;
+        double x = (double)k / 64.0;
+        A[n][0] = 1.0;
+        for (j=1; j<m; j++)
+            A[n][j] = A[n][j-1] * x;
+        n++;
+    }
+
+    // augmented matrix [A^T A | I]
+    double B[4][8];
+    for (i=0; i<m; i++) {
+        for (j=0; j<m; j++) {
+            B[i][j] = 0.0;
+            for (n=0; n<52; n++)
+                B[i][j] += A[n][i] * A[n][j];
+            B[i][m+j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+
+    // invert A^T A (Gauss-Jordan elimination with partial pivoting)
+    unsigned int r;
+    for (i=0; i<m; i++) {
+        // find pivot
+        unsigned int p = i;
+        for (r=i+1; r<m; r++) {
+            double a0 = B[r][i] < 0 ? -B[r][i] : B[r][i];
+            double a1 = B[p][i] < 0 ? -B[p][i] : B[p][i];
+            if (a0 > a1)
+                p = r;
+        }
+        for (j=0; j<2*m; j++) {
+            double t = B[i][j];
+            B[i][j] = B[p][j];
+            B[p][j] = t;
+        }
+
+        // normalize pivot row, eliminate column from remaining rows
+        double v = B[i][i];
+        for (j=0; j<2*m; j++)
+            B[i][j] /= v;
+        for (r=0; r<m; r++) {
+            if (r == i) continue;
+            double g = B[r][i];
+            for (j=0; j<2*m; j++)
+                B[r][j] -= g * B[i][j];
+        }
+    }
+
+    // print table: P = (A^T A)^-1 A^T [size: m x 52]
+    printf("// auto-generated file (do not edit)\n");
+    printf("\n");
+    printf("#include \"liquid-wlan.internal.h\"\n");
+    printf("\n");
+    printf("// least-squares polynomial fit table for order %u\n", order);
+    printf("const float wlan_eqfit_P%u[%u] = {\n", order, m*52);
+    for (i=0; i<m; i++) {
+        printf("    // coefficient %u\n", i);
+        for (n=0; n<52; n++) {
+            double v = 0.0;
+            for (j=0; j<m; j++)
+                v += B[i][m+j] * A[n][j];
+            printf("%s%16.9e,%s", (n%4)==0 ? "    " : " ", v, (n%4)==3 ? "\n" : "");
+        }
+    }
+    printf("};\n");
+
+    return 0;
+}
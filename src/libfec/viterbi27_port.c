@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <limits.h>
+#include <pthread.h>
 
 // include header with forward declarations
 #include "liquid-wlan.internal.h"
@@ -36,7 +37,7 @@
 typedef union { unsigned int w[64]; } metric_t;
 typedef union { unsigned long w[2];} decision_t;
 static union branchtab27 { unsigned char c[32]; } Branchtab27[2] __attribute__ ((aligned(16)));
-static int Init = 0;
+static pthread_once_t Init = PTHREAD_ONCE_INIT; /* decoders may be created concurrently */
 
 /* State info for instance of Viterbi decoder
  * Don't change this without also changing references in [mmx|sse|sse2]bfly29.s!
@@ -66,24 +67,32 @@ int wlan_init_viterbi27_port(void *p,int starting_state){
   return 0;
 }
 
-void wlan_set_viterbi27_polynomial_port(int polys[2]){
+static void set_viterbi27_polynomial(int polys[2]){
   int state;
 
   for(state=0;state < 32;state++){
     Branchtab27[0].c[state] = (polys[0] < 0) ^ parity((2*state) & abs(polys[0])) ? 255 : 0;
     Branchtab27[1].c[state] = (polys[1] < 0) ^ parity((2*state) & abs(polys[1])) ? 255 : 0;
   }
-  Init++;
+}
+
+/* Initialize branch table with default polynomials (once per process) */
+static void init_viterbi27_polynomial(void){
+  int polys[2] = { V27POLYA, V27POLYB };
+  set_viterbi27_polynomial(polys);
+}
+
+/* Set polynomials (not thread-safe; must precede decoder use) */
+void wlan_set_viterbi27_polynomial_port(int polys[2]){
+  pthread_once(&Init,init_viterbi27_polynomial);
+  set_viterbi27_polynomial(polys);
 }
 
 /* Create a new instance of a Viterbi decoder */
 void *wlan_create_viterbi27_port(int len){
   struct v27 *vp;
 
-  if(!Init){
-    int polys[2] = { V27POLYA, V27POLYB };
-    wlan_set_viterbi27_polynomial_port(polys);
-  }
+  pthread_once(&Init,init_viterbi27_polynomial);
   if((vp = malloc(sizeof(struct v27))) == NULL)
      return NULL;
   if((vp->decisions = malloc((len+6)*sizeof(decision_t))) == NULL){
@@ -89,6 +89,54 @@ unsigned int liquid_wlan_bdotprod(unsigned int _x,
     return c & 1;
 }
 
+// scale/convert interleaved values to float; the inner loops run over
+// fixed-size groups (16 samples) through non-aliasing pointers so that
+// they vectorize, leaving a scalar loop for the remainder
+//  _x      :   input values [size: _n x 1]
+//  _n      :   number of real values (twice the number of samples)
+//  _g      :   scale
+//  _y      :   output values [size: _n x 1]
+void liquid_wlan_convert_cf32(const float * restrict _x,
+                              unsigned int           _n,
+                              float                  _g,
+                              float * restrict       _y)
+{
+    unsigned int i, l;
+    for (i=0; i<_n/32; i++, _x+=32, _y+=32) {
+        for (l=0; l<32; l++)
+            _y[l] = _g * _x[l];
+    }
+    for (l=0; l<_n%32; l++)
+        _y[l] = _g * _x[l];
+}
+
+void liquid_wlan_convert_ci16(const int16_t * restrict _x,
+                              unsigned int             _n,
+                              float                    _g,
+                              float * restrict         _y)
+{
+    unsigned int i, l;
+    for (i=0; i<_n/32; i++, _x+=32, _y+=32) {
+        for (l=0; l<32; l++)
+            _y[l] = _g * (float)_x[l];
+    }
+    for (l=0; l<_n%32; l++)
+        _y[l] = _g * (float)_x[l];
+}
+
+void liquid_wlan_convert_ci8(const int8_t * restrict _x,
+                             unsigned int            _n,
+                             float                   _g,
+                             float * restrict        _y)
+{
+    unsigned int i, l;
+    for (i=0; i<_n/32; i++, _x+=32, _y+=32) {
+        for (l=0; l<32; l++)
+            _y[l] = _g * (float)_x[l];
+    }
+    for (l=0; l<_n%32; l++)
+        _y[l] = _g * (float)_x[l];
+}
 
 // repack bytes with arbitrary symbol sizes
 //  _sym_in             :   input symbols array [size: _sym_in_len x 1]
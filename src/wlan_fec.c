@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "liquid-wlan.internal.h"
 
@@ -130,10 +131,12 @@ void wlan_fec_encode(unsigned int    _fec_scheme,
 // decode data using convolutional code
 //  _fec_scheme :   error-correction scheme
 //  _dec_msg_len:   length of decoded message
+//  _tail_index :   bit index of the six (zero) tail bits in decoded message
 //  _msg_enc    :   encoded message
 //  _msg_dec    :   decoded message (with tail bits inserted)
 void wlan_fec_decode(unsigned int    _fec_scheme,
                      unsigned int    _dec_msg_len,
+                     unsigned int    _tail_index,
                      unsigned char * _msg_enc,
                      unsigned char * _msg_dec)
 {
@@ -147,6 +150,9 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
     } else if (_dec_msg_len == 0) {
         fprintf(stderr,"error: wlan_fec_decode(), input message length must be greater than zero\n");
         exit(1);
+    } else if (_tail_index + 6 > 8*_dec_msg_len) {
+        fprintf(stderr,"error: wlan_fec_decode(), tail bits exceed message length\n");
+        exit(1);
     }
 
     // initialize encoder options
@@ -172,28 +178,32 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
 #endif
 
     unsigned char bit;                      // input bit
-    unsigned char byte_in = _msg_dec[0];    // intput byte
 
     // unpack bytes, adding erasures at punctured indices
     // compute number of encoded bits with erasure insertions, removing
     // the additional padding to fill last OFDM symbol
     unsigned int num_enc_bits = _dec_msg_len * 8 * R; // - npad;
+
+    // number of trellis steps decoded: data bits through the end of the
+    // tail (see below)
+    unsigned int num_steps = _tail_index + K - 1;
+
     unsigned char enc_bits[num_enc_bits];
 
     if (punctured) {
-        // punctured code; add erasures at punctured indices
-        for (i=0; i<num_enc_bits; i+=R) {
+        // punctured code; add erasures at punctured indices (only through
+        // the end of the tail so as not to read past the encoded message)
+        for (i=0; i<R*num_steps; i+=R) {
             //
             for (r=0; r<R; r++) {
                 if (pmatrix[r*P + p]) {
                     // push bit from input
-                    bit = (byte_in >> (7-k)) & 0x01;
+                    bit = (_msg_enc[n] >> (7-k)) & 0x01;
                     enc_bits[i+r] = bit ? LIQUID_WLAN_SOFTBIT_1 : LIQUID_WLAN_SOFTBIT_0;
                     k++;
                     if (k==8) {
                         k = 0;
                         n++;
-                        byte_in = _msg_enc[n];
                     }
                 } else {
                     // push erasure
@@ -217,9 +227,16 @@ void wlan_fec_decode(unsigned int    _fec_scheme,
     }
 
     // run Viterbi decoder
+    // NOTE : only the K-1 tail bits return the encoder to the zero state;
+    //        any pad bits that follow are scrambled and leave it in an
+    //        arbitrary state, so the trellis is terminated at the tail and
+    //        the pad bits are not decoded (cleared in the output)
     void * vp = wlan_create_viterbi27(num_enc_bits);
     wlan_init_viterbi27(vp,0);
-    wlan_update_viterbi27_blk(vp, enc_bits, 8*_dec_msg_len + K - 1);
-    wlan_chainback_viterbi27(vp, _msg_dec, num_enc_bits, 0);
+    wlan_update_viterbi27_blk(vp, enc_bits, num_steps);
+    wlan_chainback_viterbi27(vp, _msg_dec, _tail_index, 0);
     wlan_delete_viterbi27(vp);
+
+    unsigned int num_bytes = (_tail_index + 7) / 8;
+    memset(&_msg_dec[num_bytes], 0x00, _dec_msg_len - num_bytes);
 }
@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_fft.c
+//
+// 64-point transform with run-time selectable backend: liquid-dsp, fftw
+// (if available at build time) or the built-in fixed-size kernel
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+// backend used for subsequently created transform objects
+#if HAVE_FFTW3_H
+static int wlan_fft_backend = WLAN_FFT_BACKEND_FFTW;
+#else
+static int wlan_fft_backend = WLAN_FFT_BACKEND_BUILTIN;
+#endif
+
+#if HAVE_FFTW3_H
+// fftw planner flags by effort (WLAN_FFT_PLANNER_*)
+static const unsigned int wlan_fft_planner_flags[3] = {
+    FFTW_ESTIMATE, FFTW_MEASURE, FFTW_PATIENT};
+#endif
+
+// Process-wide plan cache: plans are created on first use and shared by
+// every transform object with the same direction (and, for fftw, planner
+// effort), and are only ever executed on new arrays. The fftw planner and
+// wisdom functions are not thread-safe, so they are only called with the
+// cache lock held; executing a plan is.
+static struct {
+    pthread_mutex_t lock;
+    int planner;                    // planning effort for new fftw plans
+    char * wisdom_file;             // wisdom file updated after planning
+    unsigned int num_objects;       // number of objects using the cache
+
+    // built-in backend twiddle factors [direction]
+    struct wlan_fft64_plan_s * builtin[2];
+
+#if HAVE_FFTW3_H
+    // fftw plans [direction][planner][aligned, unaligned]
+    fftwf_plan fftw[2][3][2];
+#endif
+} wlan_fft_cache = {PTHREAD_MUTEX_INITIALIZER, WLAN_FFT_PLANNER_ESTIMATE};
+
+struct wlan_fft_s {
+    int backend;            // transform backend
+    int direction;          // WLAN_FFT_FORWARD, WLAN_FFT_BACKWARD
+    int flags;              // WLAN_FFT_FLAG_*
+    float complex * x;      // bound input array
+    float complex * y;      // bound output array
+
+    // liquid-dsp backend (bound to arrays, not shared)
+    fftplan plan_liquid;
+
+#if HAVE_FFTW3_H
+    // fftw backend (shared): plans for 16-byte aligned and unaligned
+    // arrays
+    fftwf_plan plan_fftw;
+    fftwf_plan plan_fftw_unaligned;
+#endif
+
+    // built-in backend (shared)
+    struct wlan_fft64_plan_s * plan_builtin;
+};
+
+// set transform backend for subsequently created objects, returning '1'
+// if the backend is not available, '0' otherwise
+int wlan_fft_set_backend(int _backend)
+{
+    switch (_backend) {
+    case WLAN_FFT_BACKEND_LIQUID:
+    case WLAN_FFT_BACKEND_BUILTIN:
+        break;
+    case WLAN_FFT_BACKEND_FFTW:
+#if HAVE_FFTW3_H
+        break;
+#else
+        return 1;
+#endif
+    default:
+        return 1;
+    }
+
+    __atomic_store_n(&wlan_fft_backend, _backend, __ATOMIC_RELAXED);
+    return 0;
+}
+
+// get transform backend used for subsequently created objects
+int wlan_fft_get_backend(void)
+{
+    return __atomic_load_n(&wlan_fft_backend, __ATOMIC_RELAXED);
+}
+
+// set fftw planning effort for plans created afterwards, returning '1'
+// if the value is invalid, '0' otherwise
+int wlan_fft_set_planner(int _planner)
+{
+    if (_planner < WLAN_FFT_PLANNER_ESTIMATE || _planner > WLAN_FFT_PLANNER_PATIENT)
+        return 1;
+
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    wlan_fft_cache.planner = _planner;
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return 0;
+}
+
+// get fftw planning effort for plans created afterwards
+int wlan_fft_get_planner(void)
+{
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    int planner = wlan_fft_cache.planner;
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return planner;
+}
+
+// import fftw wisdom from file, returning '1' on failure (or if fftw is
+// not available), '0' otherwise
+int wlan_fft_import_wisdom(const char * _filename)
+{
+#if HAVE_FFTW3_H
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    int rc = fftwf_import_wisdom_from_filename(_filename);
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return rc ? 0 : 1;
+#else
+    return 1;
+#endif
+}
+
+// export fftw wisdom to file, returning '1' on failure (or if fftw is not
+// available), '0' otherwise
+int wlan_fft_export_wisdom(const char * _filename)
+{
+#if HAVE_FFTW3_H
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    int rc = fftwf_export_wisdom_to_filename(_filename);
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return rc ? 0 : 1;
+#else
+    return 1;
+#endif
+}
+
+// set fftw wisdom file, importing its wisdom (if it exists) now and
+// exporting to it whenever a new plan is measured; NULL disables export.
+// Returns '1' if wisdom could not be imported, '0' otherwise.
+int wlan_fft_set_wisdom_file(const char * _filename)
+{
+    int rc = 1;
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    free(wlan_fft_cache.wisdom_file);
+    wlan_fft_cache.wisdom_file = NULL;
+    if (_filename != NULL) {
+        wlan_fft_cache.wisdom_file = (char*) malloc(strlen(_filename)+1);
+        strcpy(wlan_fft_cache.wisdom_file, _filename);
+#if HAVE_FFTW3_H
+        rc = fftwf_import_wisdom_from_filename(_filename) ? 0 : 1;
+#endif
+    }
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return rc;
+}
+
+// destroy cached plans, returning '1' (and leaving the cache intact) if
+// any transform object is still using it, '0' otherwise
+int wlan_fft_cache_clear(void)
+{
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+    if (wlan_fft_cache.num_objects > 0) {
+        pthread_mutex_unlock(&wlan_fft_cache.lock);
+        return 1;
+    }
+
+    unsigned int d;
+    for (d=0; d<2; d++) {
+        free(wlan_fft_cache.builtin[d]);
+        wlan_fft_cache.builtin[d] = NULL;
+#if HAVE_FFTW3_H
+        unsigned int p;
+        unsigned int u;
+        for (p=0; p<3; p++) {
+            for (u=0; u<2; u++) {
+                if (wlan_fft_cache.fftw[d][p][u] != NULL)
+                    fftwf_destroy_plan(wlan_fft_cache.fftw[d][p][u]);
+                wlan_fft_cache.fftw[d][p][u] = NULL;
+            }
+        }
+#endif
+    }
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+    return 0;
+}
+
+// get shared built-in plan for direction (cache lock must be held)
+struct wlan_fft64_plan_s * wlan_fft_cache_builtin(int _direction)
+{
+    unsigned int d = _direction == WLAN_FFT_FORWARD ? 0 : 1;
+    if (wlan_fft_cache.builtin[d] != NULL)
+        return wlan_fft_cache.builtin[d];
+
+    // compute twiddle factors
+    struct wlan_fft64_plan_s * p = (struct wlan_fft64_plan_s *) malloc(sizeof(struct wlan_fft64_plan_s));
+    unsigned int r;
+    unsigned int i;
+    p->sign = _direction == WLAN_FFT_FORWARD ? -1.0f : 1.0f;
+    for (r=0; r<4; r++) {
+        for (i=0; i<4; i++) {
+            p->w16_re[r*4+i] =         cosf(2*M_PI*r*i/16.0f);
+            p->w16_im[r*4+i] = p->sign*sinf(2*M_PI*r*i/16.0f);
+        }
+        for (i=0; i<16; i++) {
+            p->w64_re[r*16+i] =         cosf(2*M_PI*r*i/64.0f);
+            p->w64_im[r*16+i] = p->sign*sinf(2*M_PI*r*i/64.0f);
+        }
+    }
+    wlan_fft_cache.builtin[d] = p;
+    return p;
+}
+
+#if HAVE_FFTW3_H
+// get shared fftw plan for direction and array alignment at the current
+// planner effort (cache lock must be held)
+fftwf_plan wlan_fft_cache_fftw(int _direction,
+                               int _unaligned)
+{
+    unsigned int d = _direction == WLAN_FFT_FORWARD ? 0 : 1;
+    unsigned int p = wlan_fft_cache.planner;
+    unsigned int u = _unaligned ? 1 : 0;
+    if (wlan_fft_cache.fftw[d][p][u] != NULL)
+        return wlan_fft_cache.fftw[d][p][u];
+
+    // plan on scratch arrays (measuring overwrites them), offset by one
+    // sample for the unaligned plan; the plan is only executed on new
+    // arrays, so they are not needed afterwards
+    fftwf_complex * x = (fftwf_complex*) fftwf_malloc(65*sizeof(fftwf_complex));
+    fftwf_complex * y = (fftwf_complex*) fftwf_malloc(65*sizeof(fftwf_complex));
+    wlan_fft_cache.fftw[d][p][u] = fftwf_plan_dft_1d(64, x+u, y+u,
+            _direction == WLAN_FFT_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD,
+            wlan_fft_planner_flags[p] | (u ? FFTW_UNALIGNED : 0));
+    fftwf_free(x);
+    fftwf_free(y);
+
+    // persist newly measured plan
+    if (p != WLAN_FFT_PLANNER_ESTIMATE && wlan_fft_cache.wisdom_file != NULL)
+        fftwf_export_wisdom_to_filename(wlan_fft_cache.wisdom_file);
+
+    return wlan_fft_cache.fftw[d][p][u];
+}
+#endif
+
+// create 64-point transform object with bound arrays
+//  _x          :   input array [size: 64 x 1]
+//  _y          :   output array [size: 64 x 1]
+//  _direction  :   WLAN_FFT_FORWARD or WLAN_FFT_BACKWARD
+//  _flags      :   WLAN_FFT_FLAG_* options
+wlan_fft wlan_fft_create(float complex * _x,
+                         float complex * _y,
+                         int             _direction,
+                         int             _flags)
+{
+    void * mem = malloc(wlan_fft_sizeof());
+    return wlan_fft_init(mem, _x, _y, _direction, _flags);
+}
+
+// destroy transform object (shared plans remain cached)
+void wlan_fft_destroy(wlan_fft _q)
+{
+    wlan_fft_fini(_q);
+    free(_q);
+}
+
+// get size of transform object [bytes] (see wlan_fft_init())
+size_t wlan_fft_sizeof(void)
+{
+    return sizeof(struct wlan_fft_s);
+}
+
+// initialize transform object in place with bound arrays
+//  _mem        :   object memory [size: wlan_fft_sizeof() bytes]
+//  _x          :   input array [size: 64 x 1]
+//  _y          :   output array [size: 64 x 1]
+//  _direction  :   WLAN_FFT_FORWARD or WLAN_FFT_BACKWARD
+//  _flags      :   WLAN_FFT_FLAG_* options
+wlan_fft wlan_fft_init(void *          _mem,
+                       float complex * _x,
+                       float complex * _y,
+                       int             _direction,
+                       int             _flags)
+{
+    // validate input
+    if (_mem == NULL) {
+        fprintf(stderr,"error: wlan_fft_init(), memory is NULL\n");
+        exit(1);
+    } else if (_direction != WLAN_FFT_FORWARD && _direction != WLAN_FFT_BACKWARD) {
+        fprintf(stderr,"error: wlan_fft_init(), invalid direction\n");
+        exit(1);
+    }
+
+    wlan_fft q = (wlan_fft) _mem;
+    q->backend   = wlan_fft_get_backend();
+    q->direction = _direction;
+    q->flags     = _flags;
+    q->x         = _x;
+    q->y         = _y;
+
+    if (q->backend == WLAN_FFT_BACKEND_LIQUID) {
+        q->plan_liquid = fft_create_plan(64, q->x, q->y,
+                _direction == WLAN_FFT_FORWARD ? FFT_FORWARD : FFT_REVERSE, 0);
+        return q;
+    }
+
+    // get shared plan(s)
+    pthread_mutex_lock(&wlan_fft_cache.lock);
+#if HAVE_FFTW3_H
+    if (q->backend == WLAN_FFT_BACKEND_FFTW) {
+        q->plan_fftw           = wlan_fft_cache_fftw(_direction, 0);
+        q->plan_fftw_unaligned = wlan_fft_cache_fftw(_direction, 1);
+    }
+#endif
+    if (q->backend == WLAN_FFT_BACKEND_BUILTIN)
+        q->plan_builtin = wlan_fft_cache_builtin(_direction);
+    wlan_fft_cache.num_objects++;
+    pthread_mutex_unlock(&wlan_fft_cache.lock);
+
+    return q;
+}
+
+// release transform object resources without freeing the object memory
+void wlan_fft_fini(wlan_fft _q)
+{
+    if (_q->backend == WLAN_FFT_BACKEND_LIQUID) {
+        fft_destroy_plan(_q->plan_liquid);
+    } else {
+        pthread_mutex_lock(&wlan_fft_cache.lock);
+        wlan_fft_cache.num_objects--;
+        pthread_mutex_unlock(&wlan_fft_cache.lock);
+    }
+}
+
+// get backend used by transform object
+int wlan_fft_get_object_backend(wlan_fft _q)
+{
+    return _q->backend;
+}
+
+// execute transform on bound arrays
+void wlan_fft_execute(wlan_fft _q)
+{
+    wlan_fft_execute_dft(_q, _q->x, _q->y);
+}
+
+// execute transform on new arrays (which may be the same)
+//  _q      :   transform object
+//  _x      :   input array [size: 64 x 1]
+//  _y      :   output array [size: 64 x 1]
+void wlan_fft_execute_dft(wlan_fft        _q,
+                          float complex * _x,
+                          float complex * _y)
+{
+    switch (_q->backend) {
+    case WLAN_FFT_BACKEND_LIQUID:
+        // plan is bound to its arrays; copy through them
+        if (_x != _q->x)
+            memmove(_q->x, _x, 64*sizeof(float complex));
+        fft_execute(_q->plan_liquid);
+        if (_y != _q->y)
+            memmove(_y, _q->y, 64*sizeof(float complex));
+        break;
+#if HAVE_FFTW3_H
+    case WLAN_FFT_BACKEND_FFTW:;
+        // shared plans are out-of-place; copy in-place input aside
+        float complex t[64] __attribute__((aligned(16)));
+        if (_x == _y) {
+            memmove(t, _x, 64*sizeof(float complex));
+            _x = t;
+        }
+        int aligned = fftwf_alignment_of((float*)_x) == 0 &&
+                      fftwf_alignment_of((float*)_y) == 0;
+        fftwf_execute_dft(aligned ? _q->plan_fftw : _q->plan_fftw_unaligned,
+                          (fftwf_complex*)_x, (fftwf_complex*)_y);
+        break;
+#endif
+    default:
+        wlan_fft64_execute(_q->plan_builtin, _q->flags, _x, _y);
+    }
+}
+
+// built-in 64-point transform, decomposed into three radix-4 stages
+// (64 = 4*4*4) over split real/imaginary arrays. With the input index
+// n = c + 16*m (c in [0,15]) and c = r0 + 4*r1:
+//   stage 1:  A[m'][c]      = sum_m x[c + 16m] (-j)^(m m')
+//   stage 2:  F[r0][q + 4p] = sum_r1 W16^(r1 q) (-j)^(r1 p) A[q][r0 + 4 r1]
+//   stage 3:  y[q + 16p]    = sum_r0 W64^(r0 q) (-j)^(r0 p) F[r0][q]
+// (conjugated for the backward transform). Every loop has a fixed trip
+// count and unit-stride inner access so that the compiler can unroll and
+// vectorize it. The transform is unnormalized and may run in place.
+//  _p      :   plan (twiddle factors)
+//  _flags  :   WLAN_FFT_FLAG_* options
+//  _x      :   input array [size: 64 x 1]
+//  _y      :   output array [size: 64 x 1]
+void wlan_fft64_execute(struct wlan_fft64_plan_s * _p,
+                        int                        _flags,
+                        float complex *            _x,
+                        float complex *            _y)
+{
+    float ar[64], ai[64];   // stage 1 output, [m'*16 + c]
+    float fr[64], fi[64];   // stage 2 output, [r0*16 + q']
+    float s = _p->sign;     // multiply by s*j for (-j) forward, (+j) backward
+    const float * x = (const float *) _x;
+    float *       y = (float *) _y;
+    unsigned int c;
+    unsigned int q;
+    unsigned int r0;
+
+    // stage 1: 4-point transforms over x[c + 16m]; when the input NULL
+    // subcarriers (0, 27-37) are known to be zero, skip them
+    if (_flags & WLAN_FFT_FLAG_NULLS) {
+        wlan_fft64_stage1_nulls(x, s, ar, ai);
+    } else {
+        for (c=0; c<16; c++) {
+            float t0r = x[2*c   ] + x[2*c+64], t0i = x[2*c+ 1] + x[2*c+65];
+            float t1r = x[2*c   ] - x[2*c+64], t1i = x[2*c+ 1] - x[2*c+65];
+            float t2r = x[2*c+32] + x[2*c+96], t2i = x[2*c+33] + x[2*c+97];
+            float t3r = x[2*c+32] - x[2*c+96], t3i = x[2*c+33] - x[2*c+97];
+            ar[   c] = t0r + t2r;       ai[   c] = t0i + t2i;
+            ar[16+c] = t1r - s*t3i;     ai[16+c] = t1i + s*t3r;
+            ar[32+c] = t0r - t2r;       ai[32+c] = t0i - t2i;
+            ar[48+c] = t1r + s*t3i;     ai[48+c] = t1i - s*t3r;
+        }
+    }
+
+    // stage 2: twiddle by W16^(r1 q), 4-point transforms over r1
+    for (q=0; q<4; q++) {
+        const float * wr = &_p->w16_re[q];
+        const float * wi = &_p->w16_im[q];
+        for (r0=0; r0<4; r0++) {
+            unsigned int k = q*16 + r0;
+            float u0r = ar[k   ],                  u0i = ai[k   ];
+            float u1r = ar[k+ 4]*wr[4]-ai[k+ 4]*wi[4], u1i = ar[k+ 4]*wi[4]+ai[k+ 4]*wr[4];
+            float u2r = ar[k+ 8]*wr[8]-ai[k+ 8]*wi[8], u2i = ar[k+ 8]*wi[8]+ai[k+ 8]*wr[8];
+            float u3r = ar[k+12]*wr[12]-ai[k+12]*wi[12], u3i = ar[k+12]*wi[12]+ai[k+12]*wr[12];
+            float t0r = u0r + u2r, t0i = u0i + u2i;
+            float t1r = u0r - u2r, t1i = u0i - u2i;
+            float t2r = u1r + u3r, t2i = u1i + u3i;
+            float t3r = u1r - u3r, t3i = u1i - u3i;
+            unsigned int n = r0*16 + q;
+            fr[n   ] = t0r + t2r;       fi[n   ] = t0i + t2i;
+            fr[n+ 4] = t1r - s*t3i;     fi[n+ 4] = t1i + s*t3r;
+            fr[n+ 8] = t0r - t2r;       fi[n+ 8] = t0i - t2i;
+            fr[n+12] = t1r + s*t3i;     fi[n+12] = t1i - s*t3r;
+        }
+    }
+
+    // stage 3: twiddle by W64^(r0 q), 4-point transforms over r0
+    const float * wr = _p->w64_re;
+    const float * wi = _p->w64_im;
+    for (q=0; q<16; q++) {
+        float u0r = fr[q   ],                                 u0i = fi[q   ];
+        float u1r = fr[q+16]*wr[q+16]-fi[q+16]*wi[q+16], u1i = fr[q+16]*wi[q+16]+fi[q+16]*wr[q+16];
+        float u2r = fr[q+32]*wr[q+32]-fi[q+32]*wi[q+32], u2i = fr[q+32]*wi[q+32]+fi[q+32]*wr[q+32];
+        float u3r = fr[q+48]*wr[q+48]-fi[q+48]*wi[q+48], u3i = fr[q+48]*wi[q+48]+fi[q+48]*wr[q+48];
+        float t0r = u0r + u2r, t0i = u0i + u2i;
+        float t1r = u0r - u2r, t1i = u0i - u2i;
+        float t2r = u1r + u3r, t2i = u1i + u3i;
+        float t3r = u1r - u3r, t3i = u1i - u3i;
+        y[2*q   ] = t0r + t2r;          y[2*q+ 1] = t0i + t2i;
+        y[2*q+32] = t1r - s*t3i;        y[2*q+33] = t1i + s*t3r;
+        y[2*q+64] = t0r - t2r;          y[2*q+65] = t0i - t2i;
+        y[2*q+96] = t1r + s*t3i;        y[2*q+97] = t1i - s*t3r;
+    }
+}
+
+// built-in transform, first stage for input with zero-valued NULL
+// subcarriers: x[c+32] is NULL for c in [0,5] (and x[0]), and x[c+16]
+// is NULL for c in [11,15]
+//  _x      :   input array, interleaved [size: 128 x 1]
+//  _s      :   direction sign
+//  _ar     :   output array (real), [size: 64 x 1]
+//  _ai     :   output array (imag), [size: 64 x 1]
+void wlan_fft64_stage1_nulls(const float * _x,
+                             float         _s,
+                             float *       _ar,
+                             float *       _ai)
+{
+    unsigned int c;
+
+    // c = 0: x[0] and x[32] are NULL
+    float t2r = _x[32] + _x[96], t2i = _x[33] + _x[97];
+    float t3r = _x[32] - _x[96], t3i = _x[33] - _x[97];
+    _ar[ 0] =  t2r;         _ai[ 0] =  t2i;
+    _ar[16] = -_s*t3i;      _ai[16] =  _s*t3r;
+    _ar[32] = -t2r;         _ai[32] = -t2i;
+    _ar[48] =  _s*t3i;      _ai[48] = -_s*t3r;
+
+    // c in [1,5]: x[c+32] is NULL
+    for (c=1; c<6; c++) {
+        float x0r = _x[2*c   ],           x0i = _x[2*c+ 1];
+        float t2r = _x[2*c+32] + _x[2*c+96], t2i = _x[2*c+33] + _x[2*c+97];
+        float t3r = _x[2*c+32] - _x[2*c+96], t3i = _x[2*c+33] - _x[2*c+97];
+        _ar[   c] = x0r + t2r;      _ai[   c] = x0i + t2i;
+        _ar[16+c] = x0r - _s*t3i;   _ai[16+c] = x0i + _s*t3r;
+        _ar[32+c] = x0r - t2r;      _ai[32+c] = x0i - t2i;
+        _ar[48+c] = x0r + _s*t3i;   _ai[48+c] = x0i - _s*t3r;
+    }
+
+    // c in [6,10]: no NULL subcarriers
+    for (c=6; c<11; c++) {
+        float t0r = _x[2*c   ] + _x[2*c+64], t0i = _x[2*c+ 1] + _x[2*c+65];
+        float t1r = _x[2*c   ] - _x[2*c+64], t1i = _x[2*c+ 1] - _x[2*c+65];
+        float t2r = _x[2*c+32] + _x[2*c+96], t2i = _x[2*c+33] + _x[2*c+97];
+        float t3r = _x[2*c+32] - _x[2*c+96], t3i = _x[2*c+33] - _x[2*c+97];
+        _ar[   c] = t0r + t2r;      _ai[   c] = t0i + t2i;
+        _ar[16+c] = t1r - _s*t3i;   _ai[16+c] = t1i + _s*t3r;
+        _ar[32+c] = t0r - t2r;      _ai[32+c] = t0i - t2i;
+        _ar[48+c] = t1r + _s*t3i;   _ai[48+c] = t1i - _s*t3r;
+    }
+
+    // c in [11,15]: x[c+16] is NULL
+    for (c=11; c<16; c++) {
+        float t0r = _x[2*c   ] + _x[2*c+64], t0i = _x[2*c+ 1] + _x[2*c+65];
+        float t1r = _x[2*c   ] - _x[2*c+64], t1i = _x[2*c+ 1] - _x[2*c+65];
+        float x3r = _x[2*c+96],              x3i = _x[2*c+97];
+        _ar[   c] = t0r + x3r;      _ai[   c] = t0i + x3i;
+        _ar[16+c] = t1r + _s*x3i;   _ai[16+c] = t1i - _s*x3r;
+        _ar[32+c] = t0r - x3r;      _ai[32+c] = t0i - x3i;
+        _ar[48+c] = t1r - _s*x3i;   _ai[48+c] = t1i + _s*x3r;
+    }
+}
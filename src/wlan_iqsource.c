@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_iqsource.c
+//
+// Memory-mapped IQ recording source: raw interleaved cf32/ci16/ci8
+// files (or SigMF recordings) are mapped read-only and converted to
+// scaled complex float in cache-sized blocks straight from the mapping,
+// with no intermediate read() buffer. Recordings at their format's
+// default scale are handed to the synchronizer directly from the mapping.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLAN_IQSOURCE           0
+
+// samples converted per block (fits in L1/L2 cache)
+#define WLAN_IQSOURCE_BLOCK_LEN       (4096)
+
+// maximum length of SigMF metadata file read [bytes]
+#define WLAN_IQSOURCE_SIGMF_MAX_LEN   (1<<20)
+
+struct wlan_iqsource_s {
+    int format;                     // sample format (WLAN_IQ_*)
+    unsigned int sample_size;       // bytes per complex sample
+    float scale;                    // conversion scale
+    float sample_rate;              // sample rate [Hz] (0 if unknown)
+
+    // mapping
+    void * map;                     // mapped file (NULL if empty)
+    size_t map_len;                 // mapped length [bytes]
+    unsigned long int num_samples;  // complete samples in file
+    unsigned long int index;        // next sample to read
+
+    // conversion buffer
+    float complex buffer[WLAN_IQSOURCE_BLOCK_LEN] __attribute__((aligned(64)));
+};
+
+// internal methods
+static void wlan_iqsource_convert(wlan_iqsource     _q,
+                                  unsigned long int _index,
+                                  unsigned int      _n,
+                                  float complex *   _y);
+static int  wlan_iqsource_sigmf_datatype(const char * _meta,
+                                         float *      _sample_rate);
+
+// create IQ source from raw recording
+//  _filename   :   recording file name
+//  _format     :   sample format (WLAN_IQ_CF32, WLAN_IQ_CI16, WLAN_IQ_CI8)
+wlan_iqsource wlan_iqsource_create(const char * _filename,
+                                   int          _format)
+{
+    wlan_iqsource q = NULL;
+    if (posix_memalign((void**)&q, WLAN_MEMORY_ALIGN, sizeof(struct wlan_iqsource_s)) != 0) {
+        fprintf(stderr,"error: wlan_iqsource_create(), could not allocate memory\n");
+        exit(1);
+    }
+
+    // set format and default scale (full-scale integers to unity)
+    q->format = _format;
+    switch (q->format) {
+    case WLAN_IQ_CF32: q->sample_size = 8; q->scale = 1.0f;         break;
+    case WLAN_IQ_CI16: q->sample_size = 4; q->scale = 1.0f/32768.0f; break;
+    case WLAN_IQ_CI8:  q->sample_size = 2; q->scale = 1.0f/128.0f;   break;
+    default:
+        fprintf(stderr,"error: wlan_iqsource_create(), invalid sample format\n");
+        exit(1);
+    }
+    q->sample_rate = 0.0f;
+
+    // map file
+    int fd = open(_filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr,"error: wlan_iqsource_create(), could not open '%s'\n", _filename);
+        exit(1);
+    }
+    q->map_len     = (size_t)st.st_size;
+    q->num_samples = q->map_len / q->sample_size;
+    q->map         = NULL;
+    if (q->map_len > 0) {
+        q->map = mmap(NULL, q->map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (q->map == MAP_FAILED) {
+            fprintf(stderr,"error: wlan_iqsource_create(), could not map '%s'\n", _filename);
+            exit(1);
+        }
+        // recording is read front to back: favor aggressive read-ahead
+        madvise(q->map, q->map_len, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    q->index = 0;
+    return q;
+}
+
+// create IQ source from SigMF recording (format and sample rate are
+// read from the metadata file)
+//  _filename   :   recording base name, or name of its .sigmf-meta or
+//                  .sigmf-data file
+wlan_iqsource wlan_iqsource_create_sigmf(const char * _filename)
+{
+    // strip extension from file name
+    size_t n = strlen(_filename);
+    char base[n + 12];
+    strcpy(base, _filename);
+    if (n > 11 && (strcmp(&base[n-11], ".sigmf-meta") == 0 || strcmp(&base[n-11], ".sigmf-data") == 0))
+        base[n-11] = '\0';
+    char filename[n + 12];
+
+    // read metadata
+    sprintf(filename, "%s.sigmf-meta", base);
+    FILE * fid = fopen(filename, "r");
+    if (fid == NULL) {
+        fprintf(stderr,"error: wlan_iqsource_create_sigmf(), could not open '%s'\n", filename);
+        exit(1);
+    }
+    char * meta = (char*) malloc(WLAN_IQSOURCE_SIGMF_MAX_LEN + 1);
+    size_t meta_len = fread(meta, 1, WLAN_IQSOURCE_SIGMF_MAX_LEN, fid);
+    meta[meta_len] = '\0';
+    fclose(fid);
+
+    float sample_rate = 0.0f;
+    int format = wlan_iqsource_sigmf_datatype(meta, &sample_rate);
+    free(meta);
+    if (format < 0) {
+        fprintf(stderr,"error: wlan_iqsource_create_sigmf(), unsupported datatype in '%s'\n", filename);
+        exit(1);
+    }
+
+    // map samples
+    sprintf(filename, "%s.sigmf-data", base);
+    wlan_iqsource q = wlan_iqsource_create(filename, format);
+    q->sample_rate = sample_rate;
+    return q;
+}
+
+// destroy IQ source, unmapping recording
+void wlan_iqsource_destroy(wlan_iqsource _q)
+{
+    if (_q->map != NULL)
+        munmap(_q->map, _q->map_len);
+    free(_q);
+}
+
+// print IQ source internals
+void wlan_iqsource_print(wlan_iqsource _q)
+{
+    const char * formats[3] = {"cf32", "ci16", "ci8"};
+    printf("wlan_iqsource:\n");
+    printf("    format      :   %s (scale %g)\n", formats[_q->format], _q->scale);
+    if (_q->sample_rate > 0.0f)
+        printf("    sample rate :   %g MS/s\n", 1e-6f*_q->sample_rate);
+    printf("    samples     :   %lu / %lu\n", _q->index, _q->num_samples);
+}
+
+// rewind IQ source to start of recording
+void wlan_iqsource_reset(wlan_iqsource _q)
+{
+    _q->index = 0;
+}
+
+// set conversion scale (default: unity for cf32, 1/32768 for ci16 and
+// 1/128 for ci8)
+void wlan_iqsource_set_scale(wlan_iqsource _q,
+                             float         _scale)
+{
+    _q->scale = _scale;
+}
+
+// get number of samples in recording
+unsigned long int wlan_iqsource_get_num_samples(wlan_iqsource _q)
+{
+    return _q->num_samples;
+}
+
+// get number of samples not yet read
+unsigned long int wlan_iqsource_get_num_remaining(wlan_iqsource _q)
+{
+    return _q->num_samples - _q->index;
+}
+
+// get sample rate [Hz] from metadata (0 if unknown)
+float wlan_iqsource_get_sample_rate(wlan_iqsource _q)
+{
+    return _q->sample_rate;
+}
+
+// read samples, converting to scaled complex float; returns number of
+// samples read (short at end of recording)
+//  _q      :   IQ source object
+//  _y      :   output samples [size: _n x 1]
+//  _n      :   maximum number of samples to read
+unsigned int wlan_iqsource_read(wlan_iqsource          _q,
+                                liquid_float_complex * _y,
+                                unsigned int           _n)
+{
+    unsigned long int r = wlan_iqsource_get_num_remaining(_q);
+    unsigned int n = r < _n ? (unsigned int)r : _n;
+    wlan_iqsource_convert(_q, _q->index, n, _y);
+    _q->index += n;
+    return n;
+}
+
+// run synchronizer over samples, returning number of samples consumed
+// (short at end of recording)
+//  _q      :   IQ source object
+//  _fs     :   frame synchronizer
+//  _n      :   maximum number of samples to consume
+unsigned long int wlan_iqsource_execute(wlan_iqsource     _q,
+                                        wlanframesync     _fs,
+                                        unsigned long int _n)
+{
+    unsigned long int r = wlan_iqsource_get_num_remaining(_q);
+    unsigned long int n = r < _n ? r : _n;
+
+    unsigned long int i = 0;
+    while (i < n) {
+        unsigned int k = n - i < WLAN_IQSOURCE_BLOCK_LEN ? (unsigned int)(n - i) : WLAN_IQSOURCE_BLOCK_LEN;
+        // samples at the default scale are handed to the synchronizer
+        // directly from the mapping, otherwise converted here
+        if (_q->format == WLAN_IQ_CF32 && _q->scale == 1.0f) {
+            wlanframesync_execute(_fs, (float complex*)_q->map + _q->index + i, k);
+        } else if (_q->format == WLAN_IQ_CI16 && _q->scale == 1.0f/32768.0f) {
+            wlanframesync_execute_sc16(_fs, (const int16_t*)_q->map + 2*(_q->index + i), k);
+        } else if (_q->format == WLAN_IQ_CI8 && _q->scale == 1.0f/128.0f) {
+            wlanframesync_execute_sc8(_fs, (const int8_t*)_q->map + 2*(_q->index + i), k);
+        } else {
+            wlan_iqsource_convert(_q, _q->index + i, k, _q->buffer);
+            wlanframesync_execute(_fs, _q->buffer, k);
+        }
+        i += k;
+    }
+    _q->index += n;
+    return n;
+}
+
+//
+// internal methods
+//
+
+// convert samples from mapping to scaled complex float
+//  _q      :   IQ source object
+//  _index  :   index of first sample in recording
+//  _n      :   number of samples
+//  _y      :   output samples [size: _n x 1]
+static void wlan_iqsource_convert(wlan_iqsource     _q,
+                                  unsigned long int _index,
+                                  unsigned int      _n,
+                                  float complex *   _y)
+{
+    switch (_q->format) {
+    case WLAN_IQ_CF32:
+        liquid_wlan_convert_cf32((const float*)_q->map + 2*_index, 2*_n, _q->scale, (float*)_y);
+        break;
+    case WLAN_IQ_CI16:
+        liquid_wlan_convert_ci16((const int16_t*)_q->map + 2*_index, 2*_n, _q->scale, (float*)_y);
+        break;
+    case WLAN_IQ_CI8:
+        liquid_wlan_convert_ci8((const int8_t*)_q->map + 2*_index, 2*_n, _q->scale, (float*)_y);
+        break;
+    default:;
+    }
+}
+
+// find "core:datatype" (and "core:sample_rate") in SigMF metadata,
+// returning the sample format or -1 if not supported. Only the global
+// object's keys matter here, so a plain key search is sufficient.
+static int wlan_iqsource_sigmf_datatype(const char * _meta,
+                                        float *      _sample_rate)
+{
+    const char * p = strstr(_meta, "\"core:sample_rate\"");
+    if (p != NULL && (p = strchr(p, ':')) != NULL && (p = strchr(p+1, ':')) != NULL)
+        *_sample_rate = strtof(p+1, NULL);
+
+    p = strstr(_meta, "\"core:datatype\"");
+    if (p == NULL || (p = strchr(p + 15, '"')) == NULL)
+        return -1;
+    p++;
+
+    // multi-byte little-endian types only on little-endian hosts
+    int le = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+    if (strncmp(p, "cf32_le\"", 8) == 0 && le) return WLAN_IQ_CF32;
+    if (strncmp(p, "ci16_le\"", 8) == 0 && le) return WLAN_IQ_CI16;
+    if (strncmp(p, "ci8\"",     4) == 0)       return WLAN_IQ_CI8;
+    return -1;
+}
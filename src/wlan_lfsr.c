@@ -42,28 +42,38 @@ wlan_lfsr wlan_lfsr_create(unsigned int _m,
     // allocate memory for wlan_lfsr object
     wlan_lfsr ms = (wlan_lfsr) malloc(sizeof(struct wlan_lfsr_s));
 
+    // initialize object
+    wlan_lfsr_init(ms, _m, _g, _a);
+
+    return ms;
+}
+
+// initialize linear feedback shift register object in place (no
+// memory is allocated; see wlan_lfsr_create())
+void wlan_lfsr_init(wlan_lfsr    _ms,
+                    unsigned int _m,
+                    unsigned int _g,
+                    unsigned int _a)
+{
     // set internal values
-    ms->m = _m;         // generator polynomial length
-    ms->g = _g >> 1;    // generator polynomial (clip off most significant bit)
+    _ms->m = _m;        // generator polynomial length
+    _ms->g = _g >> 1;   // generator polynomial (clip off most significant bit)
 
     // initialize state register, reversing order
     // 0001 -> 1000
     unsigned int i;
-    ms->a = 0;
-    for (i=0; i<ms->m; i++) {
-        ms->a <<= 1;
-        ms->a |= (_a & 0x01);
+    _ms->a = 0;
+    for (i=0; i<_ms->m; i++) {
+        _ms->a <<= 1;
+        _ms->a |= (_a & 0x01);
         _a >>= 1;
     }
 
-    ms->n = (1<<_m)-1;  // sequence length, (2^m)-1
-    ms->v = ms->a;      // shift register
-    ms->b = 0;          // return bit
-
-    return ms;
+    _ms->n = (1<<_m)-1; // sequence length, (2^m)-1
+    _ms->v = _ms->a;    // shift register
+    _ms->b = 0;         // return bit
 }
 
-
 // destroy an wlan_lfsr object, freeing all internal memory
 void wlan_lfsr_destroy(wlan_lfsr _ms)
 {
@@ -58,20 +58,16 @@ unsigned int wlan_packet_compute_enc_msg_len(unsigned int _rate,
     div_t d = div(16 + 8*_length + 6, ndbps);
     unsigned int nsym = d.quot + (d.rem == 0 ? 0 : 1);
 
+#if 0
     // compute number of bits in the DATA field
     unsigned int ndata = nsym * ndbps;
 
-#if 0
     // compute number of pad bits
     unsigned int npad = ndata - (16 + 8*_length + 6);
 #endif
 
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
-
     // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
+    unsigned int enc_msg_len = (nsym * ncbps) / 8;
 
     // return length of encoded message (bytes)
     return enc_msg_len;
@@ -113,11 +109,12 @@ void wlan_packet_encode(unsigned int    _rate,
 #endif
 
     // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
+    // NOTE : ndbps is 36 for the 9 Mbps rate, so the last byte of the
+    //        DATA field is only partially used for an odd number of symbols
+    unsigned int dec_msg_len = (ndata + 7) / 8;
 
     // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
+    unsigned int enc_msg_len = (nsym * ncbps) / 8;
 
     // print status
 #if DEBUG_PACKET_CODEC
@@ -130,7 +127,7 @@ void wlan_packet_encode(unsigned int    _rate,
 
     unsigned char msg_org[dec_msg_len];         // original message
     unsigned char msg_scrambled[dec_msg_len];   // scrambled message
-    unsigned char msg_enc[enc_msg_len];         // encoded message
+    unsigned char msg_enc[enc_msg_len+1];       // encoded message (see below)
     unsigned char msg_int[enc_msg_len];         // interleaved message
 
     unsigned int i;
@@ -173,6 +170,8 @@ void wlan_packet_encode(unsigned int    _rate,
     //
     wlan_fec_encode(fec_scheme, dec_msg_len, msg_scrambled, msg_enc);
     // NOTE: tail bits are already inserted into 'decoded' message
+    // NOTE: the unused half of the last byte at 9 Mbps is encoded into the
+    //       extra byte of 'msg_enc' and dropped by the interleaver
 
 #if DEBUG_PACKET_CODEC
     // print encoded message
@@ -236,11 +235,12 @@ void wlan_packet_decode(unsigned int    _rate,
 #endif
 
     // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    unsigned int dec_msg_len = ndata / 8;
+    // NOTE : ndbps is 36 for the 9 Mbps rate, so the last byte of the
+    //        DATA field is only partially used for an odd number of symbols
+    unsigned int dec_msg_len = (ndata + 7) / 8;
 
     // compute encoded message length (number of data bytes)
-    unsigned int enc_msg_len = (dec_msg_len * ncbps) / ndbps;
+    unsigned int enc_msg_len = (nsym * ncbps) / 8;
 
 #if DEBUG_PACKET_CODEC
     // print status
@@ -276,7 +276,7 @@ void wlan_packet_decode(unsigned int    _rate,
     // decode message
     //
 
-    wlan_fec_decode(fec_scheme, dec_msg_len, msg_deint, msg_dec);
+    wlan_fec_decode(fec_scheme, dec_msg_len, 16 + 8*length, msg_deint, msg_dec);
 
 #if DEBUG_PACKET_CODEC
     // print decoded message
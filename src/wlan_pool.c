@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlan_pool.c
+//
+// Object memory pool: fixed-size blocks carved from a single aligned
+// slab, so that many objects (e.g. the synchronizers of a multi-channel
+// receiver) are placed contiguously and creating/destroying them never
+// touches (or fragments) the heap
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+struct wlan_pool_s {
+    unsigned char * slab;       // block memory [size: block_size*num_blocks]
+    size_t block_size;          // block size (multiple of WLAN_MEMORY_ALIGN)
+    unsigned int num_blocks;    // number of blocks
+
+    // free list; the link to the next free block is stored in the first
+    // bytes of each free block
+    pthread_mutex_t lock;
+    void * head;                // first free block (NULL if exhausted)
+    unsigned int num_free;      // number of free blocks
+};
+
+// create object memory pool
+//  _block_size :   minimum block size [bytes], rounded up to a multiple
+//                  of WLAN_MEMORY_ALIGN
+//  _num_blocks :   number of blocks
+wlan_pool wlan_pool_create(size_t       _block_size,
+                           unsigned int _num_blocks)
+{
+    // validate input
+    if (_block_size == 0) {
+        fprintf(stderr,"error: wlan_pool_create(), block size must be greater than zero\n");
+        exit(1);
+    } else if (_num_blocks == 0) {
+        fprintf(stderr,"error: wlan_pool_create(), number of blocks must be greater than zero\n");
+        exit(1);
+    }
+
+    wlan_pool q = (wlan_pool) malloc(sizeof(struct wlan_pool_s));
+    q->block_size = WLAN_ALIGN_SIZE(_block_size);
+    q->num_blocks = _num_blocks;
+
+    // allocate slab (aligned to cache line)
+    if (posix_memalign((void**)&q->slab, WLAN_MEMORY_ALIGN, q->block_size*q->num_blocks) != 0) {
+        fprintf(stderr,"error: wlan_pool_create(), could not allocate memory\n");
+        exit(1);
+    }
+
+    // link all blocks in address order
+    unsigned int i;
+    for (i=0; i<q->num_blocks; i++) {
+        void * next = (i+1 < q->num_blocks) ? q->slab + (i+1)*q->block_size : NULL;
+        memmove(q->slab + i*q->block_size, &next, sizeof(void*));
+    }
+    q->head     = q->slab;
+    q->num_free = q->num_blocks;
+    pthread_mutex_init(&q->lock, NULL);
+
+    return q;
+}
+
+// destroy object memory pool, releasing the slab
+void wlan_pool_destroy(wlan_pool _q)
+{
+    pthread_mutex_destroy(&_q->lock);
+    free(_q->slab);
+    free(_q);
+}
+
+// print object memory pool internals
+void wlan_pool_print(wlan_pool _q)
+{
+    printf("wlan_pool:\n");
+    printf("    block size  :   %lu bytes\n", (unsigned long)_q->block_size);
+    printf("    blocks      :   %u / %u free\n", wlan_pool_get_num_free(_q), _q->num_blocks);
+}
+
+// allocate block, returning NULL if the pool is exhausted
+void * wlan_pool_alloc(wlan_pool _q)
+{
+    pthread_mutex_lock(&_q->lock);
+    void * block = _q->head;
+    if (block != NULL) {
+        memmove(&_q->head, block, sizeof(void*));
+        _q->num_free--;
+    }
+    pthread_mutex_unlock(&_q->lock);
+    return block;
+}
+
+// return block to pool
+void wlan_pool_free(wlan_pool _q,
+                    void *    _block)
+{
+    // validate input: block must be the start of a block in the slab
+    size_t offset = (unsigned char*)_block - _q->slab;
+    if ((unsigned char*)_block < _q->slab ||
+        offset >= _q->block_size*_q->num_blocks ||
+        offset % _q->block_size)
+    {
+        fprintf(stderr,"error: wlan_pool_free(), block not allocated from pool\n");
+        exit(1);
+    }
+
+    pthread_mutex_lock(&_q->lock);
+    memmove(_block, &_q->head, sizeof(void*));
+    _q->head = _block;
+    _q->num_free++;
+    pthread_mutex_unlock(&_q->lock);
+}
+
+// get number of available blocks
+unsigned int wlan_pool_get_num_free(wlan_pool _q)
+{
+    pthread_mutex_lock(&_q->lock);
+    unsigned int num_free = _q->num_free;
+    pthread_mutex_unlock(&_q->lock);
+    return num_free;
+}
@@ -263,7 +263,7 @@ void wlan_fec_signal_decode(unsigned char * _msg_enc,
     wlan_delete_viterbi27(vp);
 #else
     // decode using generic decoding method (half-rate encoder)
-    wlan_fec_decode(LIQUID_WLAN_FEC_R1_2, 3, _msg_enc, signal_dec);
+    wlan_fec_decode(LIQUID_WLAN_FEC_R1_2, 3, 18, _msg_enc, signal_dec);
 #endif
 
     // copy result to output
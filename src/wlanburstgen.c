@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanburstgen.c
+//
+// Multi-frame burst generator: streams scheduled frames separated by
+// inter-frame gaps into a single-producer/single-consumer ring buffer
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANBURSTGEN            0
+
+// scheduled frame entry
+struct wlanburstgen_entry_s {
+    struct wlan_txvector_s txvector;    // framing options
+    unsigned int gap;                   // idle samples following frame
+    unsigned char payload[4095];        // payload (copied on push)
+};
+
+struct wlanburstgen_s {
+    // frame generator
+    wlanframegen fg;
+
+    // schedule (circular queue of frame entries), producer side only
+    struct wlanburstgen_entry_s * entries;
+    unsigned int num_entries;       // schedule capacity
+    unsigned int entry_index;       // index of next entry to generate
+    unsigned int entry_count;       // number of entries waiting
+
+    // ring buffer; the write counter is only modified by the producer
+    // and the read counter only by the consumer. Both are free-running
+    // and accessed with acquire/release semantics.
+    float complex * ring;
+    unsigned int ring_len;          // ring buffer length (power of 2)
+    unsigned long int ring_write;   // total samples written (producer)
+    unsigned long int ring_read;    // total samples read (consumer)
+
+    // producer state
+    enum {
+        WLANBURSTGEN_STATE_IDLE=0,  // waiting for scheduled frame
+        WLANBURSTGEN_STATE_FRAME,   // writing frame samples
+        WLANBURSTGEN_STATE_GAP,     // writing inter-frame gap
+    } state;
+    unsigned int gap_remaining;     // number of gap samples remaining
+    unsigned int prng;              // random payload generator state
+
+    // statistics
+    unsigned long int num_frames;   // number of frames completed
+};
+
+// create burst generator object
+//  _num_entries    :   maximum number of scheduled frames
+//  _ring_len       :   ring buffer length (rounded up to power of 2)
+wlanburstgen wlanburstgen_create(unsigned int _num_entries,
+                                 unsigned int _ring_len)
+{
+    // validate input
+    if (_num_entries == 0) {
+        fprintf(stderr,"error: wlanburstgen_create(), schedule length must be greater than zero\n");
+        exit(1);
+    } else if (_ring_len < 80) {
+        fprintf(stderr,"error: wlanburstgen_create(), ring buffer must hold at least one symbol\n");
+        exit(1);
+    }
+
+    wlanburstgen q = (wlanburstgen) malloc(sizeof(struct wlanburstgen_s));
+
+    // create frame generator
+    q->fg = wlanframegen_create();
+
+    // allocate schedule
+    q->num_entries = _num_entries;
+    q->entries = (struct wlanburstgen_entry_s*) malloc(q->num_entries*sizeof(struct wlanburstgen_entry_s));
+
+    // allocate ring buffer, rounding length up to power of 2 so that
+    // indices wrap with a mask
+    q->ring_len = 1;
+    while (q->ring_len < _ring_len)
+        q->ring_len <<= 1;
+    q->ring = (float complex*) malloc(q->ring_len*sizeof(float complex));
+
+    // reset object
+    wlanburstgen_reset(q);
+
+    return q;
+}
+
+// destroy burst generator object
+void wlanburstgen_destroy(wlanburstgen _q)
+{
+    wlanframegen_destroy(_q->fg);
+    free(_q->entries);
+    free(_q->ring);
+    free(_q);
+}
+
+// print burst generator object internals
+void wlanburstgen_print(wlanburstgen _q)
+{
+    printf("wlanburstgen:\n");
+    printf("    schedule    :   %3u / %3u entries\n", _q->entry_count, _q->num_entries);
+    printf("    ring buffer :   %6lu / %6u samples\n",
+            _q->ring_write - _q->ring_read, _q->ring_len);
+    printf("    frames      :   %lu\n", _q->num_frames);
+}
+
+// reset burst generator, clearing schedule and ring buffer; must not be
+// called while the consumer is active
+void wlanburstgen_reset(wlanburstgen _q)
+{
+    wlanframegen_reset(_q->fg);
+
+    _q->entry_index   = 0;
+    _q->entry_count   = 0;
+    _q->ring_write    = 0;
+    _q->ring_read     = 0;
+    _q->state         = WLANBURSTGEN_STATE_IDLE;
+    _q->gap_remaining = 0;
+    _q->prng          = 0x12345678;
+    _q->num_frames    = 0;
+}
+
+// schedule frame, returning '1' if schedule is full, '-1' if the rate is
+// unsupported, '0' otherwise
+//  _q          :   burst generator object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1], or NULL
+//                  for random payload
+//  _txvector   :   framing options
+//  _gap        :   number of idle (zero) samples following the frame
+int wlanburstgen_push(wlanburstgen           _q,
+                      unsigned char *        _payload,
+                      struct wlan_txvector_s _txvector,
+                      unsigned int           _gap)
+{
+    // validate input
+    if (_txvector.DATARATE > 7) {
+        fprintf(stderr,"error: wlanburstgen_push(), invalid rate\n");
+        exit(1);
+    } else if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) {
+        fprintf(stderr,"error: wlanburstgen_push(), invalid data length\n");
+        exit(1);
+    }
+
+    // unsupported rate (see wlanframe_assemble()); the frame would
+    // produce no samples
+    if (_txvector.DATARATE == WLANFRAME_RATE_9) {
+        fprintf(stderr,"error: wlanburstgen_push(), the rate 9 M bits/s is currently unsupported\n");
+        return -1;
+    }
+
+    if (_q->entry_count == _q->num_entries)
+        return 1;
+
+    // append entry to schedule
+    unsigned int k = (_q->entry_index + _q->entry_count) % _q->num_entries;
+    struct wlanburstgen_entry_s * e = &_q->entries[k];
+    e->txvector = _txvector;
+    e->gap      = _gap;
+
+    unsigned int i;
+    if (_payload != NULL) {
+        memmove(e->payload, _payload, _txvector.LENGTH*sizeof(unsigned char));
+    } else {
+        // generate random payload (xorshift)
+        for (i=0; i<_txvector.LENGTH; i++) {
+            _q->prng ^= _q->prng << 13;
+            _q->prng ^= _q->prng >> 17;
+            _q->prng ^= _q->prng << 5;
+            e->payload[i] = _q->prng & 0xff;
+        }
+    }
+
+    _q->entry_count++;
+    return 0;
+}
+
+// get number of scheduled frames not yet started
+unsigned int wlanburstgen_get_num_scheduled(wlanburstgen _q)
+{
+    return _q->entry_count;
+}
+
+// get number of frames completed
+unsigned long int wlanburstgen_get_num_frames(wlanburstgen _q)
+{
+    return _q->num_frames;
+}
+
+// (producer) generate samples into ring buffer until it is full or the
+// schedule is exhausted, returning number of samples written
+unsigned int wlanburstgen_execute(wlanburstgen _q)
+{
+    unsigned long int w = _q->ring_write;
+    unsigned long int r = __atomic_load_n(&_q->ring_read, __ATOMIC_ACQUIRE);
+    unsigned int mask = _q->ring_len - 1;
+
+    while (w - r < _q->ring_len) {
+        // contiguous free region at write pointer
+        unsigned int k = _q->ring_len - (unsigned int)(w - r);
+        unsigned int m = _q->ring_len - (unsigned int)(w & mask);
+        if (k > m) k = m;
+        float complex * y = &_q->ring[w & mask];
+
+        if (_q->state == WLANBURSTGEN_STATE_IDLE) {
+            // start next scheduled frame
+            if (_q->entry_count == 0)
+                break;
+            struct wlanburstgen_entry_s * e = &_q->entries[_q->entry_index];
+            wlanframegen_assemble(_q->fg, e->payload, e->txvector);
+            _q->gap_remaining = e->gap;
+            _q->entry_index = (_q->entry_index + 1) % _q->num_entries;
+            _q->entry_count--;
+            _q->state = WLANBURSTGEN_STATE_FRAME;
+
+        } else if (_q->state == WLANBURSTGEN_STATE_FRAME) {
+            // write frame samples directly into ring buffer; a short
+            // count signals the end of the frame
+            unsigned int n = wlanframegen_write_samples(_q->fg, y, k);
+            w += n;
+            if (n < k) {
+                _q->num_frames++;
+                _q->state = WLANBURSTGEN_STATE_GAP;
+            }
+
+        } else {
+            // write inter-frame gap
+            unsigned int n = k < _q->gap_remaining ? k : _q->gap_remaining;
+            memset(y, 0x00, n*sizeof(float complex));
+            w += n;
+            _q->gap_remaining -= n;
+            if (_q->gap_remaining == 0)
+                _q->state = WLANBURSTGEN_STATE_IDLE;
+        }
+    }
+
+    // publish samples to consumer
+    unsigned int num_written = (unsigned int)(w - _q->ring_write);
+    __atomic_store_n(&_q->ring_write, w, __ATOMIC_RELEASE);
+
+#if DEBUG_WLANBURSTGEN
+    printf("wlanburstgen_execute(): wrote %u samples\n", num_written);
+#endif
+    return num_written;
+}
+
+// (consumer) get number of samples available to read
+unsigned int wlanburstgen_get_num_available(wlanburstgen _q)
+{
+    unsigned long int w = __atomic_load_n(&_q->ring_write, __ATOMIC_ACQUIRE);
+    return (unsigned int)(w - _q->ring_read);
+}
+
+// (consumer) read samples from ring buffer, returning number read
+//  _q          :   burst generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   maximum number of samples to read
+unsigned int wlanburstgen_read(wlanburstgen    _q,
+                               float complex * _buffer,
+                               unsigned int    _n)
+{
+    unsigned long int w = __atomic_load_n(&_q->ring_write, __ATOMIC_ACQUIRE);
+    unsigned long int r = _q->ring_read;
+    unsigned int mask = _q->ring_len - 1;
+
+    unsigned int n = (unsigned int)(w - r);
+    if (n > _n) n = _n;
+
+    // copy out in (at most) two contiguous pieces
+    unsigned int n0 = _q->ring_len - (unsigned int)(r & mask);
+    if (n0 > n) n0 = n;
+    memmove(_buffer,      &_q->ring[r & mask], n0*sizeof(float complex));
+    memmove(&_buffer[n0], _q->ring,            (n-n0)*sizeof(float complex));
+
+    // release space to producer
+    __atomic_store_n(&_q->ring_read, r + n, __ATOMIC_RELEASE);
+    return n;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlancapturesync.c
+//
+// Capture decoder: decodes a complete recording by splitting it into
+// chunks which are run through independent frame synchronizers on a
+// pool of worker threads. Each chunk is preceded by an overlap region
+// long enough for a synchronizer to settle (one maximum-length frame)
+// and to complete any frame ending at the start of the chunk (another).
+// Frames are reported in capture order from the calling thread, tagged
+// with their absolute sample index; frames found by two neighbouring
+// chunks are reported once.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANCAPTURESYNC         0
+
+// tolerance on the sample index of a frame found by two neighbouring
+// chunks (one symbol; frames are never this close)
+#define WLANCAPTURESYNC_GUARD         (80)
+
+// decoded frame
+struct wlancapturesync_frame_s {
+    unsigned long int index;            // sample index past end of frame
+    int header_valid;                   // SIGNAL field valid?
+    struct wlan_rxvector_s rxvector;    // received vector
+    unsigned char * payload;            // payload (NULL if header invalid)
+};
+
+// chunk results
+struct wlancapturesync_chunk_s {
+    struct wlancapturesync_frame_s * frames;
+    unsigned int num_frames;            // number of frames decoded
+    unsigned int num_alloc;             // frames allocated
+    int done;                           // decoding complete?
+};
+
+// worker thread and its synchronizer
+struct wlancapturesync_worker_s {
+    pthread_t thread;
+    void * mem;                         // synchronizer memory (in pool)
+    wlanframesync fs;                   // synchronizer for current chunk
+    struct wlancapturesync_chunk_s * chunk;     // current chunk
+    unsigned long int offset;           // capture index of first sample run
+    unsigned long int index_min;        // first frame index kept
+    wlancapturesync q;                  // parent object
+};
+
+struct wlancapturesync_s {
+    // options
+    unsigned int num_workers;           // number of worker threads
+    unsigned int chunk_len;             // samples per chunk (excl. overlap)
+    unsigned int max_length;            // maximum payload length (bytes)
+    unsigned int overlap;               // samples run ahead of each chunk
+    wlancapturesync_callback callback;
+    void * userdata;
+
+    struct wlancapturesync_worker_s * workers;
+    wlan_pool pool;                     // synchronizer memory
+
+    // capture being decoded
+    liquid_float_complex * x;
+    unsigned long int num_samples;
+
+    // chunk scheduling: chunks are decoded in order of index and held in
+    // a window of results until reported, bounding memory use
+    struct wlancapturesync_chunk_s * chunks;    // [size: window x 1]
+    unsigned int window;                // number of chunks in flight
+    unsigned long int num_chunks;       // number of chunks in capture
+    unsigned long int next_chunk;       // next chunk to decode
+    unsigned long int next_report;      // next chunk to report
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+
+    // statistics (last capture)
+    unsigned long int num_frames;       // frames reported
+    unsigned long int num_duplicates;   // frames found by two chunks
+};
+
+// internal methods
+static void * wlancapturesync_worker_run(void * _arg);
+static void   wlancapturesync_decode_chunk(struct wlancapturesync_worker_s * _w,
+                                           unsigned long int                 _c);
+static int    wlancapturesync_sync_callback(int                    _header_valid,
+                                            unsigned char *        _payload,
+                                            struct wlan_rxvector_s _rxvector,
+                                            void *                 _userdata);
+static void   wlancapturesync_report_chunk(wlancapturesync                  _q,
+                                           struct wlancapturesync_chunk_s * _chunk,
+                                           unsigned long int *              _index_last);
+
+// create capture decoder object
+//  _num_workers    :   number of worker threads
+//  _chunk_len      :   samples per chunk (excluding overlap)
+//  _max_length     :   maximum payload length (1-4095), sets the overlap
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlancapturesync wlancapturesync_create(unsigned int             _num_workers,
+                                       unsigned int             _chunk_len,
+                                       unsigned int             _max_length,
+                                       wlancapturesync_callback _callback,
+                                       void *                   _userdata)
+{
+    // validate input
+    if (_num_workers == 0) {
+        fprintf(stderr,"error: wlancapturesync_create(), number of workers must be greater than zero\n");
+        exit(1);
+    } else if (_chunk_len < WLANCAPTURESYNC_GUARD) {
+        fprintf(stderr,"error: wlancapturesync_create(), chunk must hold at least one symbol\n");
+        exit(1);
+    } else if (_max_length == 0 || _max_length > 4095) {
+        fprintf(stderr,"error: wlancapturesync_create(), maximum length must be in [1,4095]\n");
+        exit(1);
+    }
+
+    wlancapturesync q = (wlancapturesync) malloc(sizeof(struct wlancapturesync_s));
+    q->num_workers = _num_workers;
+    q->chunk_len   = _chunk_len;
+    q->max_length  = _max_length;
+    q->callback    = _callback;
+    q->userdata    = _userdata;
+
+    // overlap: two longest frames (lowest rate, 24 data bits per symbol:
+    // preamble, SIGNAL field, and SERVICE, payload and tail bits in the
+    // DATA field) plus the index tolerance
+    unsigned int nsym = (16 + 8*q->max_length + 6 + 23) / 24;
+    q->overlap = 2*(320 + 80 + 80*nsym) + WLANCAPTURESYNC_GUARD;
+    if (q->chunk_len > UINT_MAX - q->overlap) {
+        fprintf(stderr,"error: wlancapturesync_create(), chunk too long\n");
+        exit(1);
+    }
+
+    // create workers, placing synchronizers in a pool
+    q->pool = wlan_pool_create(wlanframesync_sizeof_max_length(q->max_length), q->num_workers);
+    q->workers = (struct wlancapturesync_worker_s*) malloc(q->num_workers*sizeof(struct wlancapturesync_worker_s));
+    unsigned int i;
+    for (i=0; i<q->num_workers; i++) {
+        q->workers[i].mem = wlan_pool_alloc(q->pool);
+        q->workers[i].q   = q;
+    }
+
+    // result window
+    q->window = 2*q->num_workers;
+    q->chunks = (struct wlancapturesync_chunk_s*) malloc(q->window*sizeof(struct wlancapturesync_chunk_s));
+    memset(q->chunks, 0x00, q->window*sizeof(struct wlancapturesync_chunk_s));
+
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->cond, NULL);
+
+    q->num_frames     = 0;
+    q->num_duplicates = 0;
+    return q;
+}
+
+// destroy capture decoder object
+void wlancapturesync_destroy(wlancapturesync _q)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_workers; i++)
+        wlan_pool_free(_q->pool, _q->workers[i].mem);
+    wlan_pool_destroy(_q->pool);
+    free(_q->workers);
+
+    for (i=0; i<_q->window; i++)
+        free(_q->chunks[i].frames);
+    free(_q->chunks);
+
+    pthread_mutex_destroy(&_q->lock);
+    pthread_cond_destroy(&_q->cond);
+    free(_q);
+}
+
+// print capture decoder object internals
+void wlancapturesync_print(wlancapturesync _q)
+{
+    printf("wlancapturesync:\n");
+    printf("    workers     :   %u\n", _q->num_workers);
+    printf("    chunk       :   %u samples (+%u overlap)\n", _q->chunk_len, _q->overlap);
+    printf("    max length  :   %u bytes\n", _q->max_length);
+    printf("    frames      :   %lu (%lu duplicates removed)\n", _q->num_frames, _q->num_duplicates);
+}
+
+// get number of samples each chunk is preceded by
+unsigned int wlancapturesync_get_overlap(wlancapturesync _q)
+{
+    return _q->overlap;
+}
+
+// get number of frames found by two neighbouring chunks during the last
+// call to wlancapturesync_execute()
+unsigned long int wlancapturesync_get_num_duplicates(wlancapturesync _q)
+{
+    return _q->num_duplicates;
+}
+
+// decode capture, invoking the callback for each frame in capture order
+// from the calling thread; returns the number of frames reported
+//  _q      :   capture decoder object
+//  _x      :   capture [size: _n x 1]
+//  _n      :   number of samples in capture
+unsigned long int wlancapturesync_execute(wlancapturesync        _q,
+                                          liquid_float_complex * _x,
+                                          unsigned long int      _n)
+{
+    _q->x              = _x;
+    _q->num_samples    = _n;
+    _q->num_chunks     = (_n + _q->chunk_len - 1) / _q->chunk_len;
+    _q->next_chunk     = 0;
+    _q->next_report    = 0;
+    _q->num_frames     = 0;
+    _q->num_duplicates = 0;
+
+    // start workers (no more than there are chunks)
+    unsigned int num_workers = _q->num_chunks < _q->num_workers ? (unsigned int)_q->num_chunks : _q->num_workers;
+    unsigned int i;
+    for (i=0; i<num_workers; i++) {
+        if (pthread_create(&_q->workers[i].thread, NULL, wlancapturesync_worker_run, &_q->workers[i]) != 0) {
+            fprintf(stderr,"error: wlancapturesync_execute(), could not create worker thread\n");
+            exit(1);
+        }
+    }
+
+    // report chunks in order as they complete, releasing their slots
+    unsigned long int index_last = 0;
+    unsigned long int c;
+    for (c=0; c<_q->num_chunks; c++) {
+        struct wlancapturesync_chunk_s * chunk = &_q->chunks[c % _q->window];
+        pthread_mutex_lock(&_q->lock);
+        while (!chunk->done)
+            pthread_cond_wait(&_q->cond, &_q->lock);
+        pthread_mutex_unlock(&_q->lock);
+
+        wlancapturesync_report_chunk(_q, chunk, &index_last);
+
+        pthread_mutex_lock(&_q->lock);
+        chunk->done = 0;
+        _q->next_report++;
+        pthread_cond_broadcast(&_q->cond);
+        pthread_mutex_unlock(&_q->lock);
+    }
+
+    for (i=0; i<num_workers; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+
+#if DEBUG_WLANCAPTURESYNC
+    wlancapturesync_print(_q);
+#endif
+    return _q->num_frames;
+}
+
+//
+// internal methods
+//
+
+// worker thread: decode chunks in order of index while the result
+// window has room
+static void * wlancapturesync_worker_run(void * _arg)
+{
+    struct wlancapturesync_worker_s * w = (struct wlancapturesync_worker_s*) _arg;
+    wlancapturesync q = w->q;
+
+    pthread_mutex_lock(&q->lock);
+    while (1) {
+        while (q->next_chunk < q->num_chunks && q->next_chunk >= q->next_report + q->window)
+            pthread_cond_wait(&q->cond, &q->lock);
+        if (q->next_chunk == q->num_chunks)
+            break;
+        unsigned long int c = q->next_chunk++;
+        pthread_mutex_unlock(&q->lock);
+
+        wlancapturesync_decode_chunk(w, c);
+
+        pthread_mutex_lock(&q->lock);
+        q->chunks[c % q->window].done = 1;
+        pthread_cond_broadcast(&q->cond);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return NULL;
+}
+
+// decode chunk with a freshly initialized synchronizer, running it over
+// the overlap ahead of the chunk first
+static void wlancapturesync_decode_chunk(struct wlancapturesync_worker_s * _w,
+                                         unsigned long int                 _c)
+{
+    wlancapturesync q = _w->q;
+    unsigned long int start = _c * q->chunk_len;
+    unsigned long int end   = start + q->chunk_len;
+    if (end > q->num_samples)
+        end = q->num_samples;
+
+    _w->chunk     = &q->chunks[_c % q->window];
+    _w->offset    = start > q->overlap ? start - q->overlap : 0;
+    _w->index_min = start > WLANCAPTURESYNC_GUARD ? start - WLANCAPTURESYNC_GUARD : 0;
+
+    _w->fs = wlanframesync_init_max_length(_w->mem, wlancapturesync_sync_callback, _w, q->max_length);
+    wlanframesync_execute(_w->fs, &q->x[_w->offset], (unsigned int)(end - _w->offset));
+    wlanframesync_fini(_w->fs);
+}
+
+// synchronizer callback: save frames belonging to the chunk (or to the
+// end of the one before) along with their capture index
+static int wlancapturesync_sync_callback(int                    _header_valid,
+                                         unsigned char *        _payload,
+                                         struct wlan_rxvector_s _rxvector,
+                                         void *                 _userdata)
+{
+    struct wlancapturesync_worker_s * w = (struct wlancapturesync_worker_s*) _userdata;
+    unsigned long int index = w->offset + wlanframesync_get_num_samples(w->fs);
+    if (index < w->index_min)
+        return 0;
+
+    struct wlancapturesync_chunk_s * chunk = w->chunk;
+    if (chunk->num_frames == chunk->num_alloc) {
+        chunk->num_alloc = chunk->num_alloc == 0 ? 16 : 2*chunk->num_alloc;
+        chunk->frames = (struct wlancapturesync_frame_s*) realloc(chunk->frames,
+                            chunk->num_alloc*sizeof(struct wlancapturesync_frame_s));
+    }
+    struct wlancapturesync_frame_s * f = &chunk->frames[chunk->num_frames++];
+    f->index        = index;
+    f->header_valid = _header_valid;
+    f->rxvector     = _rxvector;
+    f->payload      = NULL;
+    if (_header_valid) {
+        f->payload = (unsigned char*) malloc(_rxvector.LENGTH*sizeof(unsigned char));
+        memmove(f->payload, _payload, _rxvector.LENGTH*sizeof(unsigned char));
+    }
+    return 0;
+}
+
+// report chunk frames, skipping those already reported by the chunk
+// before (same index within tolerance)
+static void wlancapturesync_report_chunk(wlancapturesync                  _q,
+                                         struct wlancapturesync_chunk_s * _chunk,
+                                         unsigned long int *              _index_last)
+{
+    unsigned int i;
+    for (i=0; i<_chunk->num_frames; i++) {
+        struct wlancapturesync_frame_s * f = &_chunk->frames[i];
+        if (_q->num_frames > 0 && f->index <= *_index_last + WLANCAPTURESYNC_GUARD) {
+            _q->num_duplicates++;
+        } else {
+            if (_q->callback != NULL)
+                _q->callback(f->index, f->header_valid, f->payload, f->rxvector, _q->userdata);
+            _q->num_frames++;
+            *_index_last = f->index;
+        }
+        free(f->payload);
+    }
+    _chunk->num_frames = 0;
+}
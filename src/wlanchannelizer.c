@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanchannelizer.c
+//
+// Polyphase filterbank channelizer: splits a wideband stream sampled at
+// M x 20 MS/s into M critically-sampled 20 MS/s channels spaced 20 MHz
+// (the 802.11 channel grid when the capture is centered on a channel),
+// with one M-point transform per block of M input samples. Outputs are
+// handed directly to per-channel frame synchronizers or to a multi-
+// channel receiver.
+//
+// With critical sampling, content between 10 and 20 MHz from a channel
+// center aliases to the opposite band edge; the prototype filter passes
+// the occupied 802.11 band (+/- 8.3 MHz) and stops from 11.7 MHz, so the
+// aliases only land outside the occupied band.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANCHANNELIZER         0
+
+// prototype filter semi-length (taps per branch = 2*m) and stop-band
+// attenuation [dB]
+#define WLANCHANNELIZER_SEMILEN       (12)
+#define WLANCHANNELIZER_ATTENUATION   (60.0f)
+
+// number of output samples per channel staged before being handed on
+#define WLANCHANNELIZER_OUTPUT_LEN    (256)
+
+struct wlanchannelizer_s {
+    unsigned int num_channels;  // number of channels, M
+    unsigned int h_sub_len;     // taps per branch, P
+
+    // polyphase filterbank: branch r holds prototype taps h[p*M + r] and
+    // a delay line of its input, x[(n-p)*M - r], stored twice so that it
+    // can be read contiguously from the newest sample
+    float * h_sub;              // branch filters [size: M x P]
+    float complex * w;          // branch delay lines [size: M x 2P]
+    unsigned int w_index;       // position of newest sample in delay lines
+    unsigned int block_index;   // input samples received in current block
+
+    // inverse transform of branch outputs
+    float complex * v;          // branch outputs [size: M x 1]
+    float complex * y;          // channel outputs [size: M x 1]
+    fftplan ifft;
+
+    // staged channel outputs and their destinations
+    float complex * out;        // [size: M x WLANCHANNELIZER_OUTPUT_LEN]
+    unsigned int out_len;       // samples staged per channel
+    wlanframesync * fs;         // per-channel synchronizers (NULL if unused)
+    wlanmultisync ms;           // multi-channel receiver (NULL if unused)
+};
+
+// internal methods
+static void wlanchannelizer_compute(wlanchannelizer _q);
+static void wlanchannelizer_flush(wlanchannelizer _q);
+
+// create channelizer object
+//  _num_channels   :   number of 20 MHz channels, M (input sample rate
+//                      M x 20 MS/s)
+wlanchannelizer wlanchannelizer_create(unsigned int _num_channels)
+{
+    // validate input
+    if (_num_channels < 2) {
+        fprintf(stderr,"error: wlanchannelizer_create(), number of channels must be at least 2\n");
+        exit(1);
+    }
+
+    wlanchannelizer q = (wlanchannelizer) malloc(sizeof(struct wlanchannelizer_s));
+    q->num_channels = _num_channels;
+    q->h_sub_len    = 2*WLANCHANNELIZER_SEMILEN;
+    unsigned int M  = q->num_channels;
+    unsigned int P  = q->h_sub_len;
+
+    // design prototype filter: cut-off at the channel edge (10 MHz),
+    // normalized to unity gain at the channel center
+    unsigned int h_len = M*P + 1;
+    float h[h_len];
+    liquid_firdes_kaiser(h_len, 0.5f/(float)M, WLANCHANNELIZER_ATTENUATION, 0.0f, h);
+    float g = 0.0f;
+    unsigned int i;
+    for (i=0; i<M*P; i++)
+        g += h[i];
+
+    // partition into branch filters (last tap dropped)
+    q->h_sub = (float*) malloc(M*P*sizeof(float));
+    unsigned int r;
+    unsigned int p;
+    for (r=0; r<M; r++) {
+        for (p=0; p<P; p++)
+            q->h_sub[r*P + p] = h[p*M + r] / g;
+    }
+
+    // allocate delay lines, transform buffers and output staging
+    q->w    = (float complex*) malloc(M*2*P*sizeof(float complex));
+    q->v    = (float complex*) malloc(M*sizeof(float complex));
+    q->y    = (float complex*) malloc(M*sizeof(float complex));
+    q->ifft = fft_create_plan(M, q->v, q->y, FFT_REVERSE, 0);
+    q->out  = (float complex*) malloc(M*WLANCHANNELIZER_OUTPUT_LEN*sizeof(float complex));
+
+    // no destinations
+    q->fs = (wlanframesync*) malloc(M*sizeof(wlanframesync));
+    for (i=0; i<M; i++)
+        q->fs[i] = NULL;
+    q->ms = NULL;
+
+    wlanchannelizer_reset(q);
+    return q;
+}
+
+// destroy channelizer object (synchronizers/receiver are not destroyed)
+void wlanchannelizer_destroy(wlanchannelizer _q)
+{
+    fft_destroy_plan(_q->ifft);
+    free(_q->h_sub);
+    free(_q->w);
+    free(_q->v);
+    free(_q->y);
+    free(_q->out);
+    free(_q->fs);
+    free(_q);
+}
+
+// print channelizer object internals
+void wlanchannelizer_print(wlanchannelizer _q)
+{
+    printf("wlanchannelizer: %u channels (input %g MS/s), %u taps/branch\n",
+            _q->num_channels, 20.0f*_q->num_channels, _q->h_sub_len);
+    unsigned int i;
+    for (i=0; i<_q->num_channels; i++) {
+        printf("    channel %2u : %+4d MHz%s\n", i,
+                20*wlanchannelizer_get_channel_offset(_q, i),
+                _q->fs[i] != NULL ? " (synchronizer)" : "");
+    }
+    if (_q->ms != NULL)
+        printf("    outputs pushed to multi-channel receiver\n");
+}
+
+// reset channelizer object, clearing filter state and discarding
+// partial input blocks
+void wlanchannelizer_reset(wlanchannelizer _q)
+{
+    memset(_q->w, 0x00, _q->num_channels*2*_q->h_sub_len*sizeof(float complex));
+    _q->w_index     = 0;
+    _q->block_index = 0;
+    _q->out_len     = 0;
+}
+
+// get channel center frequency offset from capture center in units of
+// the channel spacing (20 MHz): channel k is k channels above the
+// center for k < M/2 and k-M (below) otherwise
+int wlanchannelizer_get_channel_offset(wlanchannelizer _q,
+                                       unsigned int    _channel)
+{
+    if (_channel >= _q->num_channels) {
+        fprintf(stderr,"error: wlanchannelizer_get_channel_offset(), invalid channel\n");
+        exit(1);
+    }
+    return 2*_channel < _q->num_channels ? (int)_channel : (int)_channel - (int)_q->num_channels;
+}
+
+// set frame synchronizer receiving channel output, executed in the
+// caller's thread (NULL to disable)
+void wlanchannelizer_set_sync(wlanchannelizer _q,
+                              unsigned int    _channel,
+                              wlanframesync   _fs)
+{
+    if (_channel >= _q->num_channels) {
+        fprintf(stderr,"error: wlanchannelizer_set_sync(), invalid channel\n");
+        exit(1);
+    }
+    _q->fs[_channel] = _fs;
+}
+
+// set multi-channel receiver receiving all channel outputs (channel k
+// pushed to receiver channel k), or NULL to disable
+void wlanchannelizer_set_multisync(wlanchannelizer _q,
+                                   wlanmultisync   _ms)
+{
+    if (_ms != NULL && wlanmultisync_get_num_channels(_ms) < _q->num_channels) {
+        fprintf(stderr,"error: wlanchannelizer_set_multisync(), receiver has fewer than %u channels\n", _q->num_channels);
+        exit(1);
+    }
+    _q->ms = _ms;
+}
+
+// channelize one block of M input samples
+//  _q      :   channelizer object
+//  _x      :   input samples [size: M x 1]
+//  _y      :   channel outputs [size: M x 1]
+void wlanchannelizer_execute_block(wlanchannelizer        _q,
+                                   liquid_float_complex * _x,
+                                   liquid_float_complex * _y)
+{
+    if (_q->block_index != 0) {
+        fprintf(stderr,"error: wlanchannelizer_execute_block(), partial block pending\n");
+        exit(1);
+    }
+
+    // commutate input onto branches: the last sample of the block is the
+    // newest input of branch 0
+    unsigned int M = _q->num_channels;
+    unsigned int P = _q->h_sub_len;
+    unsigned int j;
+    for (j=0; j<M; j++) {
+        float complex * w = &_q->w[(M-1-j)*2*P];
+        w[_q->w_index]     = _x[j];
+        w[_q->w_index + P] = _x[j];
+    }
+    wlanchannelizer_compute(_q);
+    memmove(_y, _q->y, M*sizeof(float complex));
+}
+
+// channelize arbitrary number of input samples, handing complete channel
+// outputs to the synchronizers/receiver set for each channel. Outputs
+// pushed to a receiver are subject to its queue capacity (see
+// wlanmultisync_get_num_overflows()).
+//  _q      :   channelizer object
+//  _x      :   input samples [size: _n x 1]
+//  _n      :   number of input samples
+void wlanchannelizer_execute(wlanchannelizer        _q,
+                             liquid_float_complex * _x,
+                             unsigned int           _n)
+{
+    unsigned int M = _q->num_channels;
+    unsigned int P = _q->h_sub_len;
+    unsigned int i;
+    for (i=0; i<_n; i++) {
+        // commutate sample onto branch
+        float complex * w = &_q->w[(M-1-_q->block_index)*2*P];
+        w[_q->w_index]     = _x[i];
+        w[_q->w_index + P] = _x[i];
+        if (++_q->block_index < M)
+            continue;
+
+        // block complete: compute and stage channel outputs
+        _q->block_index = 0;
+        wlanchannelizer_compute(_q);
+
+        unsigned int k;
+        for (k=0; k<M; k++)
+            _q->out[k*WLANCHANNELIZER_OUTPUT_LEN + _q->out_len] = _q->y[k];
+        if (++_q->out_len == WLANCHANNELIZER_OUTPUT_LEN)
+            wlanchannelizer_flush(_q);
+    }
+    wlanchannelizer_flush(_q);
+}
+
+//
+// internal methods
+//
+
+// compute channel outputs from branch delay lines and advance them
+static void wlanchannelizer_compute(wlanchannelizer _q)
+{
+    unsigned int M = _q->num_channels;
+    unsigned int P = _q->h_sub_len;
+
+    // branch filters
+    unsigned int r;
+    unsigned int p;
+    for (r=0; r<M; r++) {
+        const float *         h = &_q->h_sub[r*P];
+        const float complex * w = &_q->w[r*2*P + _q->w_index];
+        float vr = 0.0f;
+        float vi = 0.0f;
+        for (p=0; p<P; p++) {
+            vr += h[p] * crealf(w[p]);
+            vi += h[p] * cimagf(w[p]);
+        }
+        _q->v[r] = vr + _Complex_I*vi;
+    }
+
+    // channel k = sum_r v[r] exp(j 2 pi k r / M)
+    fft_execute(_q->ifft);
+
+    // next block is written ahead of (newer than) this one
+    _q->w_index = (_q->w_index + P - 1) % P;
+}
+
+// hand staged channel outputs to their destinations
+static void wlanchannelizer_flush(wlanchannelizer _q)
+{
+    if (_q->out_len == 0)
+        return;
+
+    unsigned int k;
+    for (k=0; k<_q->num_channels; k++) {
+        float complex * y = &_q->out[k*WLANCHANNELIZER_OUTPUT_LEN];
+        if (_q->fs[k] != NULL)
+            wlanframesync_execute(_q->fs[k], y, _q->out_len);
+        if (_q->ms != NULL)
+            wlanmultisync_push(_q->ms, k, y, _q->out_len);
+    }
+#if DEBUG_WLANCHANNELIZER
+    printf("wlanchannelizer: flushed %u samples/channel\n", _q->out_len);
+#endif
+    _q->out_len = 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframe.c
+//
+// Assembled (encoded) frame, independent of the frame generator. Each
+// object owns all of its memory and the encoding chain uses only
+// constant tables, so distinct frames may be assembled concurrently
+// while another frame is being modulated.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+// create assembled frame object
+wlanframe wlanframe_create()
+{
+    void * mem = malloc(wlanframe_sizeof());
+    return wlanframe_init(mem);
+}
+
+// destroy assembled frame object
+void wlanframe_destroy(wlanframe _f)
+{
+    wlanframe_fini(_f);
+    free(_f);
+}
+
+// get maximum encoded message length over all rates (bytes)
+static unsigned int wlanframe_get_enc_msg_max(void)
+{
+    unsigned int r;
+    unsigned int enc_msg_max = 0;
+    for (r=0; r<8; r++) {
+        unsigned int n = wlan_packet_compute_enc_msg_len(r, 4095);
+        if (n > enc_msg_max)
+            enc_msg_max = n;
+    }
+    return enc_msg_max;
+}
+
+// get size of frame object including its encoded message [bytes]
+size_t wlanframe_sizeof(void)
+{
+    return sizeof(struct wlanframe_s) + wlanframe_get_enc_msg_max();
+}
+
+// initialize frame object in place; the encoded message is sized for
+// the longest frame (maximum length over all rates) and follows the
+// object so that assembly never needs to re-allocate
+//  _mem    :   object memory [size: wlanframe_sizeof() bytes]
+wlanframe wlanframe_init(void * _mem)
+{
+    if (_mem == NULL) {
+        fprintf(stderr,"error: wlanframe_init(), memory is NULL\n");
+        exit(1);
+    }
+
+    wlanframe f = (wlanframe) _mem;
+    f->enc_msg_max = wlanframe_get_enc_msg_max();
+    f->msg_enc = (unsigned char*) _mem + sizeof(struct wlanframe_s);
+    f->assembled = 0;
+
+    return f;
+}
+
+// release frame object resources without freeing the object memory
+void wlanframe_fini(wlanframe _f)
+{
+    // all memory is held in the object block
+    _f->assembled = 0;
+}
+
+// print assembled frame object internals
+void wlanframe_print(wlanframe _f)
+{
+    printf("wlanframe:\n");
+    if (!_f->assembled) {
+        printf("    (not assembled)\n");
+        return;
+    }
+    printf("    rate        :   %3u Mbits/s\n", wlanframe_ratetab[_f->rate].rate);
+    printf("    payload     :   %3u bytes\n", _f->length);
+    printf("    ndbps       :   %3u (data bits per OFDM symbol)\n", _f->ndbps);
+    printf("    ncbps       :   %3u (coded bits per OFDM symbol)\n", _f->ncbps);
+    printf("    nbpsc       :   %3u (bits per subcarrier, mod. depth)\n", _f->nbpsc);
+    printf("    nsym        :   %3u (number of OFDM symbols)\n", _f->nsym);
+    printf("    ndata       :   %3u (number of bits in DATA field)\n", _f->ndata);
+    printf("    npad        :   %3u (number of pad bits)\n", _f->npad);
+    printf("    dec msg len :   %3u (bytes in decoded message)\n", _f->dec_msg_len);
+    printf("    enc msg len :   %3u (bytes in encoded message)\n", _f->enc_msg_len);
+    printf("    bytes/sym   :   %3u (number of encoded data bytes per OFDM symbol)\n", _f->bytes_per_symbol);
+    printf("    signal dec  :   [%.2x %.2x %.2x]\n",
+            _f->signal_dec[0],
+            _f->signal_dec[1],
+            _f->signal_dec[2]);
+    printf("    signal enc  :   [%.2x %.2x %.2x %.2x %.2x %.2x]\n",
+            _f->signal_enc[0],
+            _f->signal_enc[1],
+            _f->signal_enc[2],
+            _f->signal_enc[3],
+            _f->signal_enc[4],
+            _f->signal_enc[5]);
+    printf("    signal int  :   [%.2x %.2x %.2x %.2x %.2x %.2x]\n",
+            _f->signal_int[0],
+            _f->signal_int[1],
+            _f->signal_int[2],
+            _f->signal_int[3],
+            _f->signal_int[4],
+            _f->signal_int[5]);
+}
+
+// assemble frame (see Table 76), returning '0' on success and '1' if
+// the rate is unsupported
+//  _f          :   frame object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+int wlanframe_assemble(wlanframe              _f,
+                       unsigned char *        _payload,
+                       struct wlan_txvector_s _txvector)
+{
+    // validate input
+    if (_txvector.DATARATE > 7) {
+        fprintf(stderr,"error: wlanframe_assemble(), invalid rate\n");
+        exit(1);
+    } else if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) { 
+        fprintf(stderr,"error: wlanframe_assemble(), invalid data length\n");
+        exit(1);
+    }
+
+#if 1
+    if (_txvector.DATARATE == WLANFRAME_RATE_9) {
+        fprintf(stderr,"error: wlanframe_assemble(), the rate 9 M bits/s is currently unsupported\n");
+        _f->assembled = 0;
+        return 1;
+    }
+#endif
+
+    // set internal properties
+    _f->rate   = _txvector.DATARATE;
+    _f->length = _txvector.LENGTH;
+    _f->seed   = 0x5d;  //(_txvector.SERVICE >> 9) & 0x7f;
+    // TODO : strip off TXPWR_LEVEL
+
+    _f->mod_scheme = wlanframe_ratetab[_f->rate].mod_scheme;
+
+    // pack SIGNAL field
+    unsigned int R = 0; // 'reserved' bit
+    wlan_signal_pack(_f->rate, R, _f->length, _f->signal_dec);
+
+    // encode SIGNAL field
+    wlan_fec_signal_encode(_f->signal_dec, _f->signal_enc);
+
+    // interleave SIGNAL field
+    wlan_interleaver_encode_symbol(WLANFRAME_RATE_6, _f->signal_enc, _f->signal_int);
+
+    // compute frame parameters
+    _f->ndbps  = wlanframe_ratetab[_f->rate].ndbps; // number of data bits per OFDM symbol
+    _f->ncbps  = wlanframe_ratetab[_f->rate].ncbps; // number of coded bits per OFDM symbol
+    _f->nbpsc  = wlanframe_ratetab[_f->rate].nbpsc; // number of bits per subcarrier (modulation depth)
+
+    // compute number of OFDM symbols:
+    // prepend the 16 SERVICE bits and append the 6 tail bits
+    div_t d = div(16 + 8*_f->length + 6, _f->ndbps);
+    _f->nsym = d.quot + (d.rem == 0 ? 0 : 1);
+
+    // compute number of bits in the DATA field
+    _f->ndata = _f->nsym * _f->ndbps;
+
+    // compute number of pad bits
+    _f->npad = _f->ndata - (16 + 8*_f->length + 6);
+
+    // compute decoded message length (number of data bytes)
+    // NOTE : ndbps is 36 for the 9 Mbps rate, so the last byte of the
+    //        DATA field is only partially used for an odd number of symbols
+    _f->dec_msg_len = (_f->ndata + 7) / 8;
+
+    // compute number of encoded data bytes per OFDM symbol
+    // (ncbps is always divisible by 8)
+    _f->bytes_per_symbol = _f->ncbps / 8;
+
+    // compute encoded message length (number of data bytes)
+    _f->enc_msg_len = _f->nsym * _f->bytes_per_symbol;
+
+    // encode message into pre-allocated buffer
+    wlan_packet_encode(_f->rate, _f->seed, _f->length, _payload, _f->msg_enc);
+
+    // flag frame as being assembled
+    _f->assembled = 1;
+    return 0;
+}
+
+// get number of samples in frame (preamble, SIGNAL, DATA and trailing
+// null symbol), or zero if frame is not assembled
+unsigned int wlanframe_get_num_samples(wlanframe _f)
+{
+    return _f->assembled ? 80*(5 + _f->nsym + 1) : 0;
+}
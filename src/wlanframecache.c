@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//
+// wlanframecache.c
+//
+// Cache of fully rendered frame waveforms, keyed by rate, scrambler
+// seed and payload, with least-recently-used eviction under a memory
+// budget. Frames start and end with the generator in its reset state,
+// so a rendered waveform is independent of what was transmitted before
+// it and may be replayed verbatim.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANFRAMECACHE            0
+
+// number of hash table buckets (power of 2)
+#define WLANFRAMECACHE_NUM_BUCKETS      (256)
+
+struct wlanframecache_s {
+    // hash table (chained) and LRU list of entries
+    struct wlanframecache_entry_s * buckets[WLANFRAMECACHE_NUM_BUCKETS];
+    struct wlanframecache_entry_s * lru_head;   // most recently used
+    struct wlanframecache_entry_s * lru_tail;   // least recently used
+
+    // memory budget
+    unsigned int max_bytes;         // maximum number of bytes held
+    unsigned int num_bytes;         // number of bytes held
+    unsigned int num_entries;       // number of entries held
+
+    // objects for rendering frames on a miss
+    wlanframe    frame;
+    wlanframegen fg;
+
+    // statistics
+    unsigned long int num_lookups;  // number of cache look-ups
+    unsigned long int num_hits;     // number of cache hits
+};
+
+// compute payload hash (32-bit FNV-1a)
+static unsigned int wlanframecache_hash(unsigned char * _payload,
+                                        unsigned int    _length)
+{
+    unsigned int h = 2166136261u;
+    unsigned int i;
+    for (i=0; i<_length; i++) {
+        h ^= _payload[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// number of bytes accounted against budget for an entry
+static unsigned int wlanframecache_entry_bytes(unsigned int _num_samples,
+                                               unsigned int _length)
+{
+    return sizeof(struct wlanframecache_entry_s) +
+           _num_samples*sizeof(float complex) +
+           _length*sizeof(unsigned char);
+}
+
+// remove entry from LRU list
+static void wlanframecache_lru_unlink(wlanframecache                  _q,
+                                      struct wlanframecache_entry_s * _e)
+{
+    if (_e->lru_prev != NULL) _e->lru_prev->lru_next = _e->lru_next;
+    else                      _q->lru_head           = _e->lru_next;
+    if (_e->lru_next != NULL) _e->lru_next->lru_prev = _e->lru_prev;
+    else                      _q->lru_tail           = _e->lru_prev;
+}
+
+// insert entry at head of LRU list (most recently used)
+static void wlanframecache_lru_push(wlanframecache                  _q,
+                                    struct wlanframecache_entry_s * _e)
+{
+    _e->lru_prev = NULL;
+    _e->lru_next = _q->lru_head;
+    if (_q->lru_head != NULL) _q->lru_head->lru_prev = _e;
+    else                      _q->lru_tail           = _e;
+    _q->lru_head = _e;
+}
+
+// remove entry from cache and free its memory
+static void wlanframecache_evict(wlanframecache                  _q,
+                                 struct wlanframecache_entry_s * _e)
+{
+    // remove from hash chain
+    struct wlanframecache_entry_s ** p = &_q->buckets[_e->hash & (WLANFRAMECACHE_NUM_BUCKETS-1)];
+    while (*p != _e)
+        p = &(*p)->hash_next;
+    *p = _e->hash_next;
+
+    wlanframecache_lru_unlink(_q, _e);
+
+    _q->num_bytes -= wlanframecache_entry_bytes(_e->num_samples, _e->length);
+    _q->num_entries--;
+
+#if DEBUG_WLANFRAMECACHE
+    printf("wlanframecache: evicted entry (%u samples)\n", _e->num_samples);
+#endif
+    free(_e->samples);
+    free(_e->payload);
+    free(_e);
+}
+
+// create frame cache object
+//  _max_bytes  :   memory budget for cached frames [bytes]
+wlanframecache wlanframecache_create(unsigned int _max_bytes)
+{
+    wlanframecache q = (wlanframecache) malloc(sizeof(struct wlanframecache_s));
+    q->max_bytes = _max_bytes;
+
+    unsigned int i;
+    for (i=0; i<WLANFRAMECACHE_NUM_BUCKETS; i++)
+        q->buckets[i] = NULL;
+    q->lru_head    = NULL;
+    q->lru_tail    = NULL;
+    q->num_bytes   = 0;
+    q->num_entries = 0;
+
+    // create rendering objects
+    q->frame = wlanframe_create();
+    q->fg    = wlanframegen_create();
+
+    q->num_lookups = 0;
+    q->num_hits    = 0;
+
+    return q;
+}
+
+// destroy frame cache object
+void wlanframecache_destroy(wlanframecache _q)
+{
+    // free all entries
+    while (_q->lru_head != NULL)
+        wlanframecache_evict(_q, _q->lru_head);
+
+    wlanframe_destroy(_q->frame);
+    wlanframegen_destroy(_q->fg);
+    free(_q);
+}
+
+// print frame cache object internals
+void wlanframecache_print(wlanframecache _q)
+{
+    printf("wlanframecache:\n");
+    printf("    entries     :   %u\n", _q->num_entries);
+    printf("    memory      :   %u / %u bytes\n", _q->num_bytes, _q->max_bytes);
+    printf("    hit rate    :   %lu / %lu (%.2f %%)\n",
+            _q->num_hits, _q->num_lookups, 100.0f*wlanframecache_get_hit_rate(_q));
+}
+
+// reset frame cache object, evicting all entries not in use and
+// clearing statistics
+void wlanframecache_reset(wlanframecache _q)
+{
+    struct wlanframecache_entry_s * e = _q->lru_head;
+    while (e != NULL) {
+        struct wlanframecache_entry_s * next = e->lru_next;
+        if (e->num_users == 0)
+            wlanframecache_evict(_q, e);
+        e = next;
+    }
+
+    _q->num_lookups = 0;
+    _q->num_hits    = 0;
+}
+
+// get fraction of look-ups which were hits
+float wlanframecache_get_hit_rate(wlanframecache _q)
+{
+    return _q->num_lookups == 0 ? 0.0f : (float)_q->num_hits / (float)_q->num_lookups;
+}
+
+// get number of cache hits
+unsigned long int wlanframecache_get_num_hits(wlanframecache _q)
+{
+    return _q->num_hits;
+}
+
+// get number of cache look-ups
+unsigned long int wlanframecache_get_num_lookups(wlanframecache _q)
+{
+    return _q->num_lookups;
+}
+
+// get number of bytes held by cache
+unsigned int wlanframecache_get_num_bytes(wlanframecache _q)
+{
+    return _q->num_bytes;
+}
+
+// get number of frames held by cache
+unsigned int wlanframecache_get_num_entries(wlanframecache _q)
+{
+    return _q->num_entries;
+}
+
+// look up frame waveform, rendering and inserting it on a miss; returns
+// entry marked in use, or NULL if the frame cannot be cached
+//  _q          :   frame cache object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+struct wlanframecache_entry_s * wlanframecache_acquire(wlanframecache         _q,
+                                                      unsigned char *        _payload,
+                                                      struct wlan_txvector_s _txvector)
+{
+    // validate input
+    if (_txvector.DATARATE > 7) {
+        fprintf(stderr,"error: wlanframecache_acquire(), invalid rate\n");
+        exit(1);
+    } else if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) {
+        fprintf(stderr,"error: wlanframecache_acquire(), invalid data length\n");
+        exit(1);
+    } else if (_txvector.DATARATE == WLANFRAME_RATE_9) {
+        fprintf(stderr,"error: wlanframecache_acquire(), the rate 9 M bits/s is currently unsupported\n");
+        exit(1);
+    }
+
+    unsigned int rate   = _txvector.DATARATE;
+    unsigned int seed   = 0x5d; // see wlanframe_assemble()
+    unsigned int length = _txvector.LENGTH;
+    unsigned int hash   = wlanframecache_hash(_payload, length);
+    _q->num_lookups++;
+
+    // search hash chain, comparing payload to guard against collisions
+    struct wlanframecache_entry_s * e = _q->buckets[hash & (WLANFRAMECACHE_NUM_BUCKETS-1)];
+    for ( ; e != NULL; e = e->hash_next) {
+        if (e->hash   == hash   &&
+            e->rate   == rate   &&
+            e->seed   == seed   &&
+            e->length == length &&
+            memcmp(e->payload, _payload, length) == 0)
+        {
+            // hit: move to head of LRU list
+            _q->num_hits++;
+            wlanframecache_lru_unlink(_q, e);
+            wlanframecache_lru_push(_q, e);
+            e->num_users++;
+            return e;
+        }
+    }
+
+    // miss: compute frame length (see wlanframe_assemble()) and make
+    // room, evicting least-recently-used entries not in use
+    unsigned int ndbps = wlanframe_ratetab[rate].ndbps;
+    unsigned int nsym  = (16 + 8*length + 6 + ndbps - 1) / ndbps;
+    unsigned int num_samples = 80*(5 + nsym + 1);
+    unsigned int num_bytes   = wlanframecache_entry_bytes(num_samples, length);
+    if (num_bytes > _q->max_bytes)
+        return NULL;
+
+    struct wlanframecache_entry_s * v = _q->lru_tail;
+    while (_q->num_bytes + num_bytes > _q->max_bytes && v != NULL) {
+        struct wlanframecache_entry_s * prev = v->lru_prev;
+        if (v->num_users == 0)
+            wlanframecache_evict(_q, v);
+        v = prev;
+    }
+    if (_q->num_bytes + num_bytes > _q->max_bytes)
+        return NULL;
+
+    // render frame
+    e = (struct wlanframecache_entry_s*) malloc(sizeof(struct wlanframecache_entry_s));
+    e->rate        = rate;
+    e->seed        = seed;
+    e->length      = length;
+    e->hash        = hash;
+    e->num_samples = num_samples;
+    e->num_users   = 1;
+    e->payload     = (unsigned char*) malloc(length*sizeof(unsigned char));
+    e->samples     = (float complex*) malloc(num_samples*sizeof(float complex));
+    memmove(e->payload, _payload, length*sizeof(unsigned char));
+
+    wlanframe_assemble(_q->frame, _payload, _txvector);
+    wlanframegen_reset(_q->fg);
+    wlanframegen_load(_q->fg, _q->frame);
+    wlanframegen_write_samples(_q->fg, e->samples, num_samples);
+
+    // insert into hash chain and LRU list
+    unsigned int b = hash & (WLANFRAMECACHE_NUM_BUCKETS-1);
+    e->hash_next = _q->buckets[b];
+    _q->buckets[b] = e;
+    wlanframecache_lru_push(_q, e);
+    _q->num_bytes += num_bytes;
+    _q->num_entries++;
+
+#if DEBUG_WLANFRAMECACHE
+    printf("wlanframecache: inserted entry (%u samples, %u bytes held)\n",
+            num_samples, _q->num_bytes);
+#endif
+    return e;
+}
+
+// release entry acquired with wlanframecache_acquire()
+void wlanframecache_release(wlanframecache                  _q,
+                            struct wlanframecache_entry_s * _e)
+{
+    _e->num_users--;
+}
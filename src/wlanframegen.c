@@ -32,47 +32,40 @@
 
 #define DEBUG_WLANFRAMEGEN            0
 
+// maximum window transition length (cyclic prefix length)
+#define WLANFRAMEGEN_RAMPUP_MAX_LEN   (16)
+
+// Object layout: the generator lives in a single block (see
+// wlanframegen_sizeof()) holding, in order, the object itself, the
+// transform object and the two internal frames
 struct wlanframegen_s {
-    // options
-    unsigned int rate;      // primitive data rate
-    unsigned int length;    // original data length (bytes)
-    unsigned int seed;      // data scrambler seed
+    // transform buffers
+    float complex X[64] __attribute__((aligned(64))); // frequency-domain buffer
+    float complex x[64];    // time-domain buffer
+    wlan_fft ifft;          // ifft object
 
     float g;                // scaling factor (gain)
-
-    // transform object
-    FFT_PLAN ifft;          // ifft object
-    float complex * X;      // frequency-domain buffer
-    float complex * x;      // time-domain buffer
+    float complex modtab[64];   // DATA field modulation table, scaled by 'g'
 
     // pilot sequence generator
-    wlan_lfsr ms_pilot;     // g = x^7 + x^4 + 1 = 1001 0001(bin) = 0x91(hex)
+    struct wlan_lfsr_s ms_pilot;    // g = x^7 + x^4 + 1 = 1001 0001(bin) = 0x91(hex)
     
-    // DATA field modulation scheme
-    unsigned int mod_scheme;
-
     // window transition
     unsigned int rampup_len;        // number of samples in overlapping symbols
-    float * rampup;                 // ramp up window (ramp down is time-reversed)
-    float complex * postfix;        // overlapping symbol buffer
-
-    // lengths
-    unsigned int ndbps;             // number of data bits per OFDM symbol
-    unsigned int ncbps;             // number of coded bits per OFDM symbol
-    unsigned int nbpsc;             // number of bits per subcarrier (modulation depth)
-    unsigned int dec_msg_len;       // length of decoded message (bytes)
-    unsigned int enc_msg_len;       // length of encoded message (bytes)
-    unsigned int nsym;              // number of OFDM symbols in the DATA field
-    unsigned int ndata;             // number of bits in the DATA field
-    unsigned int npad;              // number of pad bits
-    unsigned int bytes_per_symbol;  // number of encoded data bytes per OFDM symbol
-
-    // data arrays
-    unsigned char   signal_dec[3];  // decoded message (SIGNAL field)
-    unsigned char   signal_enc[6];  // encoded message (SIGNAL field)
-    unsigned char   signal_int[6];  // interleaved message (SIGNAL field)
-    unsigned char * msg_enc;        // encoded message (DATA field)
-    unsigned char   modem_syms[48]; // modem symbols
+    float rampup[WLANFRAMEGEN_RAMPUP_MAX_LEN];          // ramp up window (ramp down is time-reversed)
+    float complex postfix[WLANFRAMEGEN_RAMPUP_MAX_LEN]; // overlapping symbol buffer
+
+    // assembled frames (not owned unless internal)
+    wlanframe frame;                // frame being generated (NULL if idle)
+    wlanframe frame_queue;          // queued frame (NULL if empty)
+    wlanframe frame_int[2];         // internally assembled frames
+    unsigned char modem_syms[48];   // modem symbols
+
+    // cached frame waveforms (see wlanframegen_set_cache())
+    wlanframecache cache;           // waveform cache (NULL if disabled)
+    struct wlanframecache_entry_s * entry;       // waveform being replayed
+    struct wlanframecache_entry_s * entry_queue; // queued waveform
+    unsigned int entry_index;       // read index into waveform
     
     // counters/states
     enum {
@@ -84,32 +77,81 @@ struct wlanframegen_s {
         WLANFRAMEGEN_STATE_DATA,    // write payload symbols
         WLANFRAMEGEN_STATE_NULL,    // write null (effectively ramp-down) symbol
     } state;
-    int frame_assembled;            // frame assembled flag
     unsigned int data_symbol_counter;
+
+    // output sample buffer (see wlanframegen_write_samples())
+    float complex buf_sym[80];      // partially-written symbol
+    unsigned int  buf_index;        // read index into symbol buffer
 };
 
+// get internal frame object which is not in use by '_exclude'
+static wlanframe wlanframegen_get_frame_int(wlanframegen _q,
+                                            wlanframe    _exclude)
+{
+    return _q->frame_int[0] != _exclude ? _q->frame_int[0] : _q->frame_int[1];
+}
+
 // create WLAN framing generator object
 wlanframegen wlanframegen_create()
 {
-    wlanframegen q = (wlanframegen) malloc(sizeof(struct wlanframegen_s));
+    // allocate object memory (aligned to cache line)
+    void * mem = NULL;
+    if (posix_memalign(&mem, WLAN_MEMORY_ALIGN, wlanframegen_sizeof()) != 0) {
+        fprintf(stderr,"error: wlanframegen_create(), could not allocate memory\n");
+        exit(1);
+    }
+    return wlanframegen_init(mem);
+}
+
+// destroy WLAN framing generator object
+void wlanframegen_destroy(wlanframegen _q)
+{
+    wlanframegen_fini(_q);
 
-    // allocate memory for transform objects
-    q->X = (float complex*) malloc(64*sizeof(float complex));
-    q->x = (float complex*) malloc(64*sizeof(float complex));
-    q->ifft = FFT_CREATE_PLAN(64, q->X, q->x, FFT_DIR_BACKWARD, FFT_METHOD);
+    // free main object memory
+    free(_q);
+}
 
-    // create pilot sequence generator
-    q->ms_pilot = wlan_lfsr_create(7, 0x91, 0x7f);
+// get size of WLAN framing generator object block [bytes]
+size_t wlanframegen_sizeof(void)
+{
+    return WLAN_ALIGN_SIZE(sizeof(struct wlanframegen_s)) +
+           WLAN_ALIGN_SIZE(wlan_fft_sizeof()) +
+           WLAN_ALIGN_SIZE(wlanframe_sizeof()) * 2;
+}
 
-    // DATA field (payload) modulator
-    q->mod_scheme = WLAN_MODEM_BPSK;
+// initialize WLAN framing generator object in caller-provided memory
+//  _mem    :   object memory [size: wlanframegen_sizeof() bytes,
+//              aligned to WLAN_MEMORY_ALIGN]
+wlanframegen wlanframegen_init(void * _mem)
+{
+    // validate input
+    if (_mem == NULL) {
+        fprintf(stderr,"error: wlanframegen_init(), memory is NULL\n");
+        exit(1);
+    } else if ((uintptr_t)_mem % WLAN_MEMORY_ALIGN) {
+        fprintf(stderr,"error: wlanframegen_init(), memory must be aligned to %u bytes\n", WLAN_MEMORY_ALIGN);
+        exit(1);
+    }
 
-    // create transition window/buffer
+    // clear block and partition: object, transform, internal frames
+    memset(_mem, 0x00, wlanframegen_sizeof());
+    unsigned char * p = (unsigned char*) _mem;
+    wlanframegen q = (wlanframegen) p;
+    p += WLAN_ALIGN_SIZE(sizeof(struct wlanframegen_s));
+    q->ifft = wlan_fft_init(p, q->X, q->x, WLAN_FFT_BACKWARD, WLAN_FFT_FLAG_NULLS);
+    p += WLAN_ALIGN_SIZE(wlan_fft_sizeof());
+    q->frame_int[0] = wlanframe_init(p);
+    p += WLAN_ALIGN_SIZE(wlanframe_sizeof());
+    q->frame_int[1] = wlanframe_init(p);
+
+    // initialize pilot sequence generator
+    wlan_lfsr_init(&q->ms_pilot, 7, 0x91, 0x7f);
+
+    // initialize transition window
     // NOTE : ramp length must be less than cyclic prefix length (default: 1)
     // TODO : make ramp length an input parameter
     q->rampup_len = 1;
-    q->rampup = (float*) malloc( q->rampup_len * sizeof(float) );
-    q->postfix = (float complex*) malloc( q->rampup_len * sizeof(float complex) );
 
     // initialize ramp/up transition
     unsigned int i;
@@ -127,17 +169,18 @@ wlanframegen wlanframegen_create()
     }
 #endif
 
-    // set initial properties
-    q->rate   = WLANFRAME_RATE_6;
-    q->length = 100;
-    q->seed   = 0x5d;
+    // compute scaling factor: inverse transform normalization, 1/sqrt(64),
+    // folded into modulation table and pilots rather than applied to the
+    // time-domain output
+    q->g = 0.125f;
 
-    // allocate memory for encoded message
-    q->enc_msg_len = wlan_packet_compute_enc_msg_len(q->rate, q->length);
-    q->msg_enc = (unsigned char*) malloc(q->enc_msg_len*sizeof(unsigned char));
+    // empty frame queue
+    q->frame_queue = NULL;
 
-    // compute scaling factor
-    q->g = 1.0f / 64.0f;
+    // disable waveform cache
+    q->cache       = NULL;
+    q->entry       = NULL;
+    q->entry_queue = NULL;
 
     // reset objects
     wlanframegen_reset(q);
@@ -145,75 +188,49 @@ wlanframegen wlanframegen_create()
     return q;
 }
 
-// destroy WLAN framing generator object
-void wlanframegen_destroy(wlanframegen _q)
+// release WLAN framing generator object resources without freeing the
+// object memory
+void wlanframegen_fini(wlanframegen _q)
 {
-    // free transform array memory
-    free(_q->X);
-    free(_q->x);
-    FFT_DESTROY_PLAN(_q->ifft);
-    
-    // destroy pilot sequence generator
-    wlan_lfsr_destroy(_q->ms_pilot);
-
-    // free transition window ramp array and postfix buffer
-    free(_q->rampup);
-    free(_q->postfix);
+    // release cached waveforms
+    wlanframegen_set_cache(_q, NULL);
 
-    // free memory for encoded message
-    free(_q->msg_enc);
+    // release transform object
+    wlan_fft_fini(_q->ifft);
 
-    // free main object memory
-    free(_q);
+    // release internal frames
+    wlanframe_fini(_q->frame_int[0]);
+    wlanframe_fini(_q->frame_int[1]);
 }
 
 // print WLAN framing generator object internals
 void wlanframegen_print(wlanframegen _q)
 {
     printf("wlanframegen:\n");
-    if (_q->frame_assembled) {
-        printf("    rate        :   %3u Mbits/s\n", wlanframe_ratetab[_q->rate].rate);
-        printf("    payload     :   %3u bytes\n", _q->length);
-        printf("    ndbps       :   %3u (data bits per OFDM symbol)\n", _q->ndbps);
-        printf("    ncbps       :   %3u (coded bits per OFDM symbol)\n", _q->ncbps);
-        printf("    nbpsc       :   %3u (bits per subcarrier, mod. depth)\n", _q->nbpsc);
-        printf("    nsym        :   %3u (number of OFDM symbols)\n", _q->nsym);
-        printf("    ndata       :   %3u (number of bits in DATA field)\n", _q->ndata);
-        printf("    npad        :   %3u (number of pad bits)\n", _q->npad);
-        printf("    dec msg len :   %3u (bytes in decoded message)\n", _q->dec_msg_len);
-        printf("    enc msg len :   %3u (bytes in encoded message)\n", _q->enc_msg_len);
-        printf("    bytes/sym   :   %3u (number of encoded data bytes per OFDM symbol)\n", _q->bytes_per_symbol);
-        printf("    signal dec  :   [%.2x %.2x %.2x]\n",
-                _q->signal_dec[0],
-                _q->signal_dec[1],
-                _q->signal_dec[2]);
-        printf("    signal enc  :   [%.2x %.2x %.2x %.2x %.2x %.2x]\n",
-                _q->signal_enc[0],
-                _q->signal_enc[1],
-                _q->signal_enc[2],
-                _q->signal_enc[3],
-                _q->signal_enc[4],
-                _q->signal_enc[5]);
-        printf("    signal int  :   [%.2x %.2x %.2x %.2x %.2x %.2x]\n",
-                _q->signal_int[0],
-                _q->signal_int[1],
-                _q->signal_int[2],
-                _q->signal_int[3],
-                _q->signal_int[4],
-                _q->signal_int[5]);
-    }
+    if (_q->frame != NULL)
+        wlanframe_print(_q->frame);
+    else if (_q->entry != NULL)
+        printf("    replaying cached frame (%u samples)\n", _q->entry->num_samples);
 }
 
 // reset WLAN framing generator object internal state
 void wlanframegen_reset(wlanframegen _q)
 {
     // reset state/counters
-    _q->frame_assembled = 0;
+    _q->frame = NULL;
+    if (_q->entry != NULL) {
+        wlanframecache_release(_q->cache, _q->entry);
+        _q->entry = NULL;
+    }
     _q->state = WLANFRAMEGEN_STATE_S0A;
     _q->data_symbol_counter = 0;
 
+    // clear partially-written symbol
+    // NOTE : queued frame (if any) is retained
+    _q->buf_index = 80;
+
     // reset pilot sequence generator
-    wlan_lfsr_reset(_q->ms_pilot);
+    wlan_lfsr_reset(&_q->ms_pilot);
 
     // clear internal postfix buffer
     unsigned int i;
@@ -235,86 +252,94 @@ void wlanframegen_reset(wlanframegen _q)
     _q->X[37] = 0.0f;
 }
 
-// assemble frame (see Table 76)
+// assemble frame (see Table 76) into internal frame object and load it,
+// returning '-1' if the rate is unsupported
 //  _q          :   framing object
 //  _payload    :   raw payload data [size: _opts.LENGTH x 1]
 //  _txvector   :   framing options
-void wlanframegen_assemble(wlanframegen           _q,
-                           unsigned char *        _payload,
-                           struct wlan_txvector_s _txvector)
+int wlanframegen_assemble(wlanframegen           _q,
+                          unsigned char *        _payload,
+                          struct wlan_txvector_s _txvector)
 {
-    // validate input
-    if (_txvector.DATARATE > 7) {
-        fprintf(stderr,"error: wlanframegen_assemble(), invalid rate\n");
-        exit(1);
-    } else if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) { 
-        fprintf(stderr,"error: wlanframegen_assemble(), invalid data length\n");
-        exit(1);
-    }
-
-#if 1
+    // unsupported rate (see wlanframe_assemble())
     if (_txvector.DATARATE == WLANFRAME_RATE_9) {
         fprintf(stderr,"error: wlanframegen_assemble(), the rate 9 M bits/s is currently unsupported\n");
-        return;
+        return -1;
     }
-#endif
-
-    // set internal properties
-    _q->rate   = _txvector.DATARATE;
-    _q->length = _txvector.LENGTH;
-    _q->seed   = 0x5d;  //(_txvector.SERVICE >> 9) & 0x7f;
-    // TODO : strip off TXPWR_LEVEL
-
-    _q->mod_scheme = wlanframe_ratetab[_q->rate].mod_scheme;
-
-    // pack SIGNAL field
-    unsigned int R = 0; // 'reserved' bit
-    wlan_signal_pack(_q->rate, R, _q->length, _q->signal_dec);
-
-    // encode SIGNAL field
-    wlan_fec_signal_encode(_q->signal_dec, _q->signal_enc);
 
-    // interleave SIGNAL field
-    wlan_interleaver_encode_symbol(WLANFRAME_RATE_6, _q->signal_enc, _q->signal_int);
-
-    // compute frame parameters
-    _q->ndbps  = wlanframe_ratetab[_q->rate].ndbps; // number of data bits per OFDM symbol
-    _q->ncbps  = wlanframe_ratetab[_q->rate].ncbps; // number of coded bits per OFDM symbol
-    _q->nbpsc  = wlanframe_ratetab[_q->rate].nbpsc; // number of bits per subcarrier (modulation depth)
+    // replay cached waveform, if available
+    if (_q->cache != NULL) {
+        struct wlanframecache_entry_s * e = wlanframecache_acquire(_q->cache, _payload, _txvector);
+        if (e != NULL) {
+            wlanframegen_load_entry(_q, e);
+            return 0;
+        }
+    }
 
-    // compute number of OFDM symbols:
-    // prepend the 16 SERVICE bits and append the 6 tail bits
-    div_t d = div(16 + 8*_q->length + 6, _q->ndbps);
-    _q->nsym = d.quot + (d.rem == 0 ? 0 : 1);
+    // assemble into internal frame not held by queue
+    wlanframe f = wlanframegen_get_frame_int(_q, _q->frame_queue);
+    if (wlanframe_assemble(f, _payload, _txvector))
+        return -1;
 
-    // compute number of bits in the DATA field
-    _q->ndata = _q->nsym * _q->ndbps;
+    wlanframegen_load(_q, f);
+    return 0;
+}
 
-    // compute number of pad bits
-    _q->npad = _q->ndata - (16 + 8*_q->length + 6);
+// load assembled frame for modulation
+//  _q          :   framing generator object
+//  _frame      :   assembled frame
+void wlanframegen_load(wlanframegen _q,
+                       wlanframe    _frame)
+{
+    // validate input
+    if (!_frame->assembled) {
+        fprintf(stderr,"error: wlanframegen_load(), frame not assembled\n");
+        exit(1);
+    }
 
-    // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    // NOT TRUE: for rate 9, ndbps is 36 which is NOT divisible by 8!
-    _q->dec_msg_len = _q->ndata / 8;
+    // generate scaled modulation table
+    unsigned int i;
+    for (i=0; i<(1U<<_frame->nbpsc); i++)
+        _q->modtab[i] = _q->g * wlan_modulate(_frame->mod_scheme, i);
 
-    // compute encoded message length (number of data bytes)
-    _q->enc_msg_len = (_q->dec_msg_len * _q->ncbps) / _q->ndbps;
-    
-    // compute number of encoded data bytes per OFDM symbol
-    _q->bytes_per_symbol = _q->enc_msg_len / _q->nsym;
+    // abandon cached waveform being replayed, if any
+    if (_q->entry != NULL) {
+        wlanframecache_release(_q->cache, _q->entry);
+        _q->entry = NULL;
+    }
 
-    // validate encoded message length
-    //assert(_q->enc_msg_len == wlan_packet_compute_enc_msg_len(_q->rate, _q->length));
+    _q->frame = _frame;
+}
 
-    // re-allocate buffer for encoded message
-    _q->msg_enc = (unsigned char*) realloc(_q->msg_enc, _q->enc_msg_len*sizeof(unsigned char));
+// set waveform cache, or NULL to disable
+//  _q          :   framing generator object
+//  _cache      :   frame waveform cache
+void wlanframegen_set_cache(wlanframegen   _q,
+                            wlanframecache _cache)
+{
+    // release waveforms held from previous cache
+    if (_q->entry != NULL) {
+        wlanframecache_release(_q->cache, _q->entry);
+        _q->entry = NULL;
+        wlanframegen_reset(_q);
+    }
+    if (_q->entry_queue != NULL) {
+        wlanframecache_release(_q->cache, _q->entry_queue);
+        _q->entry_queue = NULL;
+    }
 
-    // encode message
-    wlan_packet_encode(_q->rate, _q->seed, _q->length, _payload, _q->msg_enc);
+    _q->cache = _cache;
+}
 
-    // flag frame as being assembled
-    _q->frame_assembled = 1;
+// load cached waveform for replay
+//  _q          :   framing generator object
+//  _e          :   cache entry, acquired by caller
+void wlanframegen_load_entry(wlanframegen                    _q,
+                             struct wlanframecache_entry_s * _e)
+{
+    wlanframegen_reset(_q);
+    _q->entry       = _e;
+    _q->entry_index = 0;
 }
 
 
@@ -325,11 +350,23 @@ int wlanframegen_writesymbol(wlanframegen    _q,
                              float complex * _buffer)
 {
     // validate input
-    if (!_q->frame_assembled) {
+    if (_q->frame == NULL && _q->entry == NULL) {
         fprintf(stderr,"error: wlanframegen_writesymbol(), frame not assembled\n");
         exit(1);
     }
 
+    // replay cached waveform
+    if (_q->entry != NULL) {
+        memmove(_buffer, &_q->entry->samples[_q->entry_index], 80*sizeof(float complex));
+        _q->entry_index += 80;
+        if (_q->entry_index < _q->entry->num_samples)
+            return 0;
+
+        // frame complete; reset and return
+        wlanframegen_reset(_q);
+        return 1;
+    }
+
     //
     switch (_q->state) {
     case WLANFRAMEGEN_STATE_S0A:
@@ -356,11 +393,14 @@ int wlanframegen_writesymbol(wlanframegen    _q,
         wlanframegen_writesymbol_data(_q, _buffer);
         _q->data_symbol_counter++;
 
-        if (_q->data_symbol_counter == _q->nsym)
+        if (_q->data_symbol_counter == _q->frame->nsym)
             _q->state = WLANFRAMEGEN_STATE_NULL;
         return 0;
     case WLANFRAMEGEN_STATE_NULL:
         wlanframegen_writesymbol_null(_q, _buffer);
+
+        // frame complete; reset and return
+        wlanframegen_reset(_q);
         return 1;
     default:
         // should never get to this point
@@ -368,9 +408,150 @@ int wlanframegen_writesymbol(wlanframegen    _q,
         exit(1);
     }
 
-    // reset and return
-    wlanframegen_reset(_q);
-    return 1;
+    return 0;
+}
+
+// queue frame to be generated once the current frame completes; the
+// frame is assembled immediately into an internal frame object. Returns
+// '1' if a frame is already queued, '-1' if the rate is unsupported
+//  _q          :   framing generator object
+//  _payload    :   raw payload data [size: _txvector.LENGTH x 1]
+//  _txvector   :   framing options
+int wlanframegen_queue(wlanframegen           _q,
+                       unsigned char *        _payload,
+                       struct wlan_txvector_s _txvector)
+{
+    // validate input
+    if (_txvector.LENGTH == 0 || _txvector.LENGTH > 4095) {
+        fprintf(stderr,"error: wlanframegen_queue(), invalid data length\n");
+        exit(1);
+    }
+
+    // unsupported rate (see wlanframe_assemble())
+    if (_txvector.DATARATE == WLANFRAME_RATE_9) {
+        fprintf(stderr,"error: wlanframegen_queue(), the rate 9 M bits/s is currently unsupported\n");
+        return -1;
+    }
+
+    // check if queue is occupied
+    if (_q->frame_queue != NULL || _q->entry_queue != NULL)
+        return 1;
+
+    // replay cached waveform, if available
+    if (_q->cache != NULL) {
+        struct wlanframecache_entry_s * e = wlanframecache_acquire(_q->cache, _payload, _txvector);
+        if (e != NULL) {
+            if (_q->frame == NULL && _q->entry == NULL)
+                wlanframegen_load_entry(_q, e);
+            else
+                _q->entry_queue = e;
+            return 0;
+        }
+    }
+
+    // assemble into internal frame not currently being generated
+    wlanframe f = wlanframegen_get_frame_int(_q, _q->frame);
+    if (wlanframe_assemble(f, _payload, _txvector))
+        return -1;
+
+    return wlanframegen_queue_frame(_q, f);
+}
+
+// queue assembled frame to be loaded once the current frame completes
+//  _q          :   framing generator object
+//  _frame      :   assembled frame
+int wlanframegen_queue_frame(wlanframegen _q,
+                             wlanframe    _frame)
+{
+    // validate input
+    if (!_frame->assembled) {
+        fprintf(stderr,"error: wlanframegen_queue_frame(), frame not assembled\n");
+        exit(1);
+    }
+
+    // check if queue is occupied
+    if (_q->frame_queue != NULL || _q->entry_queue != NULL)
+        return 1;
+
+    // load immediately if generator is idle
+    if (_q->frame == NULL && _q->entry == NULL) {
+        wlanframegen_load(_q, _frame);
+        return 0;
+    }
+
+
+    _q->frame_queue = _frame;
+    return 0;
+}
+
+// write arbitrary number of samples, spanning symbol and frame
+// boundaries, returning number of frame samples written
+//  _q          :   framing generator object
+//  _buffer     :   output sample buffer [size: _n x 1]
+//  _n          :   number of samples to write
+unsigned int wlanframegen_write_samples(wlanframegen    _q,
+                                        float complex * _buffer,
+                                        unsigned int    _n)
+{
+    unsigned int i = 0;             // output sample index
+    unsigned int num_written = 0;   // number of frame samples written
+
+    while (i < _n) {
+        // drain remainder of partially-written symbol
+        if (_q->buf_index < 80) {
+            unsigned int k = 80 - _q->buf_index;
+            if (k > _n - i) k = _n - i;
+            memmove(&_buffer[i], &_q->buf_sym[_q->buf_index], k*sizeof(float complex));
+            _q->buf_index += k;
+            i             += k;
+            num_written   += k;
+            continue;
+        }
+
+        // continue into queued frame
+        if (_q->frame == NULL && _q->entry == NULL) {
+            if (_q->entry_queue != NULL) {
+                wlanframegen_load_entry(_q, _q->entry_queue);
+                _q->entry_queue = NULL;
+            } else if (_q->frame_queue != NULL) {
+                wlanframegen_load(_q, _q->frame_queue);
+                _q->frame_queue = NULL;
+            }
+        }
+
+        // replay cached waveform directly to output
+        if (_q->entry != NULL) {
+            unsigned int k = _q->entry->num_samples - _q->entry_index;
+            if (k > _n - i) k = _n - i;
+            memmove(&_buffer[i], &_q->entry->samples[_q->entry_index], k*sizeof(float complex));
+            _q->entry_index += k;
+            i               += k;
+            num_written     += k;
+            if (_q->entry_index == _q->entry->num_samples)
+                wlanframegen_reset(_q);
+            continue;
+        }
+
+        // no frame available: zero-pad remainder of output
+        if (_q->frame == NULL) {
+            memset(&_buffer[i], 0x00, (_n - i)*sizeof(float complex));
+            break;
+        }
+
+        if (_n - i >= 80) {
+            // write full symbol directly to output
+            wlanframegen_writesymbol(_q, &_buffer[i]);
+            i           += 80;
+            num_written += 80;
+        } else {
+            // write symbol to internal buffer and drain on next pass
+            // NOTE : writesymbol() resets buffer index at end of frame
+            wlanframegen_writesymbol(_q, _q->buf_sym);
+            _q->buf_index = 0;
+        }
+    }
+
+    return num_written;
 }
 
 // 
@@ -383,18 +564,19 @@ int wlanframegen_writesymbol(wlanframegen    _q,
 void wlanframegen_compute_symbol(wlanframegen _q)
 {
     // update pilot phase
-    unsigned int pilot_phase = wlan_lfsr_advance(_q->ms_pilot);
+    unsigned int pilot_phase = wlan_lfsr_advance(&_q->ms_pilot);
 
-    // set pilots
-    _q->X[43] = pilot_phase ? -1.0f :  1.0f;
-    _q->X[57] = pilot_phase ? -1.0f :  1.0f;
-    _q->X[ 7] = pilot_phase ? -1.0f :  1.0f;
-    _q->X[21] = pilot_phase ?  1.0f : -1.0f;
+    // set pilots (scaled by gain)
+    float p = pilot_phase ? -_q->g : _q->g;
+    _q->X[43] =  p;
+    _q->X[57] =  p;
+    _q->X[ 7] =  p;
+    _q->X[21] = -p;
 
     // NOTE : NULL subcarriers have been set to zero in reset() method
 
     // run inverse transform
-    FFT_EXECUTE(_q->ifft);
+    wlan_fft_execute(_q->ifft);
 }
 
 // generate symbol (add cyclic prefix/postfix, overlap)
@@ -416,16 +598,14 @@ void wlanframegen_gensymbol(float complex * _x,
         exit(1);
     }
 
-    // copy input symbol with cyclic prefix to output symbol
-    memmove(&_symbol[ 0], &_x[48], 16*sizeof(float complex));
-    memmove(&_symbol[16], &_x[ 0], 64*sizeof(float complex));
-
-    // apply window to over-lapping regions
+    // write each output sample once: cyclic prefix windowed against
+    // post-fix of previous symbol, then remainder of cyclic prefix and
+    // symbol body
     unsigned int i;
-    for (i=0; i<_p; i++) {
-        _symbol[i] *= _rampup[i];
-        _symbol[i] += _x_prime[i] * _rampup[_p-i-1];
-    }
+    for (i=0; i<_p; i++)
+        _symbol[i] = _x[48+i]*_rampup[i] + _x_prime[i]*_rampup[_p-i-1];
+    memcpy(&_symbol[_p], &_x[48+_p], (16-_p)*sizeof(float complex));
+    memcpy(&_symbol[16], _x,         64*sizeof(float complex));
 
     // copy post-fix to output (first _p samples of input symbol)
     memmove(_x_prime, _x, _p*sizeof(float complex));
@@ -507,73 +687,17 @@ void wlanframegen_writesymbol_S1b(wlanframegen _q,
 void wlanframegen_writesymbol_signal(wlanframegen _q,
                                      float complex * _buffer)
 {
-    // load 48 SIGNAL BPSK symbols onto appropriate subcarriers
-    _q->X[38] = (_q->signal_int[0] & 0x80) ? 1.0f : -1.0f;
-    _q->X[39] = (_q->signal_int[0] & 0x40) ? 1.0f : -1.0f;
-    _q->X[40] = (_q->signal_int[0] & 0x20) ? 1.0f : -1.0f;
-    _q->X[41] = (_q->signal_int[0] & 0x10) ? 1.0f : -1.0f;
-    _q->X[42] = (_q->signal_int[0] & 0x08) ? 1.0f : -1.0f;
-    //    43  : pilot
-    _q->X[44] = (_q->signal_int[0] & 0x04) ? 1.0f : -1.0f;
-    _q->X[45] = (_q->signal_int[0] & 0x02) ? 1.0f : -1.0f;
-    _q->X[46] = (_q->signal_int[0] & 0x01) ? 1.0f : -1.0f;
-    _q->X[47] = (_q->signal_int[1] & 0x80) ? 1.0f : -1.0f;
-    _q->X[48] = (_q->signal_int[1] & 0x40) ? 1.0f : -1.0f;
-    _q->X[49] = (_q->signal_int[1] & 0x20) ? 1.0f : -1.0f;
-    _q->X[50] = (_q->signal_int[1] & 0x10) ? 1.0f : -1.0f;
-    _q->X[51] = (_q->signal_int[1] & 0x08) ? 1.0f : -1.0f;
-    _q->X[52] = (_q->signal_int[1] & 0x04) ? 1.0f : -1.0f;
-    _q->X[53] = (_q->signal_int[1] & 0x02) ? 1.0f : -1.0f;
-    _q->X[54] = (_q->signal_int[1] & 0x01) ? 1.0f : -1.0f;
-    _q->X[55] = (_q->signal_int[2] & 0x80) ? 1.0f : -1.0f;
-    _q->X[56] = (_q->signal_int[2] & 0x40) ? 1.0f : -1.0f;
-    //    57  : pilot
-    _q->X[58] = (_q->signal_int[2] & 0x20) ? 1.0f : -1.0f;
-    _q->X[59] = (_q->signal_int[2] & 0x10) ? 1.0f : -1.0f;
-    _q->X[60] = (_q->signal_int[2] & 0x08) ? 1.0f : -1.0f;
-    _q->X[61] = (_q->signal_int[2] & 0x04) ? 1.0f : -1.0f;
-    _q->X[62] = (_q->signal_int[2] & 0x02) ? 1.0f : -1.0f;
-    _q->X[63] = (_q->signal_int[2] & 0x01) ? 1.0f : -1.0f;
-    //     0  : NULL
-    _q->X[ 1] = (_q->signal_int[3] & 0x80) ? 1.0f : -1.0f;
-    _q->X[ 2] = (_q->signal_int[3] & 0x40) ? 1.0f : -1.0f;
-    _q->X[ 3] = (_q->signal_int[3] & 0x20) ? 1.0f : -1.0f;
-    _q->X[ 4] = (_q->signal_int[3] & 0x10) ? 1.0f : -1.0f;
-    _q->X[ 5] = (_q->signal_int[3] & 0x08) ? 1.0f : -1.0f;
-    _q->X[ 6] = (_q->signal_int[3] & 0x04) ? 1.0f : -1.0f;
-    //     7  : pilot
-    _q->X[ 8] = (_q->signal_int[3] & 0x02) ? 1.0f : -1.0f;
-    _q->X[ 9] = (_q->signal_int[3] & 0x01) ? 1.0f : -1.0f;
-    _q->X[10] = (_q->signal_int[4] & 0x80) ? 1.0f : -1.0f;
-    _q->X[11] = (_q->signal_int[4] & 0x40) ? 1.0f : -1.0f;
-    _q->X[12] = (_q->signal_int[4] & 0x20) ? 1.0f : -1.0f;
-    _q->X[13] = (_q->signal_int[4] & 0x10) ? 1.0f : -1.0f;
-    _q->X[14] = (_q->signal_int[4] & 0x08) ? 1.0f : -1.0f;
-    _q->X[15] = (_q->signal_int[4] & 0x04) ? 1.0f : -1.0f;
-    _q->X[16] = (_q->signal_int[4] & 0x02) ? 1.0f : -1.0f;
-    _q->X[17] = (_q->signal_int[4] & 0x01) ? 1.0f : -1.0f;
-    _q->X[18] = (_q->signal_int[5] & 0x80) ? 1.0f : -1.0f;
-    _q->X[19] = (_q->signal_int[5] & 0x40) ? 1.0f : -1.0f;
-    _q->X[20] = (_q->signal_int[5] & 0x20) ? 1.0f : -1.0f;
-    //    21  : pilot
-    _q->X[22] = (_q->signal_int[5] & 0x10) ? 1.0f : -1.0f;
-    _q->X[23] = (_q->signal_int[5] & 0x08) ? 1.0f : -1.0f;
-    _q->X[24] = (_q->signal_int[5] & 0x04) ? 1.0f : -1.0f;
-    _q->X[25] = (_q->signal_int[5] & 0x02) ? 1.0f : -1.0f;
-    _q->X[26] = (_q->signal_int[5] & 0x01) ? 1.0f : -1.0f;
+    // load 48 SIGNAL BPSK symbols onto appropriate subcarriers; values
+    // are scaled by gain (validate against Table G.11 / 8)
+    unsigned int i;
+    for (i=0; i<48; i++) {
+        unsigned int bit = (_q->frame->signal_int[i/8] >> (7 - (i%8))) & 0x01;
+        _q->X[wlanframe_sc_data[i]] = bit ? _q->g : -_q->g;
+    }
 
-    // run transform
+    // run transform (validate against Table G.12)
     wlanframegen_compute_symbol(_q);
 
-    // validate against Table G.11
-
-    // apply gain
-    unsigned int i;
-    for (i=0; i<64; i++)
-        _q->x[i] /= sqrtf(64.0f);
-    
-    // validate against Table G.12
-
     // generate SIGNAL symbol
     wlanframegen_gensymbol(_q->x,
                            _q->postfix,
@@ -586,42 +710,31 @@ void wlanframegen_writesymbol_signal(wlanframegen _q,
 void wlanframegen_writesymbol_data(wlanframegen _q,
                                    float complex * _buffer)
 {
-    // unpack modem symbols
-    //printf("  %3u = %3u * %3u\n", _q->enc_msg_len, _q->nsym, _q->bytes_per_symbol);
-    unsigned int num_written;
-    liquid_wlan_repack_bytes(&_q->msg_enc[_q->data_symbol_counter * _q->bytes_per_symbol], 8, _q->bytes_per_symbol,
-                             _q->modem_syms, _q->nbpsc, 48,
-                             &num_written);
-    assert(num_written == 48);
-
-    // modulate symbols onto subcarriers
-    // TODO : do this more efficiently
+    // unpack modem symbols (most-significant bit first); equivalent to
+    // liquid_wlan_repack_bytes() but shifts whole bytes into accumulator
+    unsigned int    nbpsc = _q->frame->nbpsc;
+    unsigned char * msg   = &_q->frame->msg_enc[_q->data_symbol_counter * _q->frame->bytes_per_symbol];
+    unsigned int mask  = (1U << nbpsc) - 1;
+    unsigned int v     = 0;     // bit accumulator
+    unsigned int nbits = 0;     // number of valid bits in accumulator
     unsigned int i;
-    unsigned int n=0;
-    for (i=0; i<64; i++) {
-        unsigned int k = (i + 32) % 64;
-
-        if ( k==0 || (k > 26 && k < 38) ) {
-            // NULL subcarrier
-        } else if (k==43 || k==57 || k==7 || k==21) {
-            // PILOT subcarrier
-        } else {
-            // DATA subcarrier
-            assert(n<48);
-            _q->X[k] = wlan_modulate(_q->mod_scheme, _q->modem_syms[n]);
-            n++;
+    for (i=0; i<48; i++) {
+        if (nbits < nbpsc) {
+            v = (v << 8) | *msg++;
+            nbits += 8;
         }
+        nbits -= nbpsc;
+        _q->modem_syms[i] = (v >> nbits) & mask;
     }
-    assert(n==48);
+
+    // modulate symbols onto DATA subcarriers using scaled table
+    for (i=0; i<48; i++)
+        _q->X[wlanframe_sc_data[i]] = _q->modtab[_q->modem_syms[i]];
 
     // run transform
     wlanframegen_compute_symbol(_q);
 
-    // apply gain
-    for (i=0; i<64; i++)
-        _q->x[i] /= sqrtf(64.0f);
-    
-    // generate SIGNAL symbol
+    // generate DATA symbol
     wlanframegen_gensymbol(_q->x,
                            _q->postfix,
                            _q->rampup,
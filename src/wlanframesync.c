@@ -35,11 +35,32 @@
 #define DEBUG_WLANFRAMESYNC_FILENAME    "wlanframesync_internal_debug.m"
 #define DEBUG_WLANFRAMESYNC_BUFFER_LEN  (2048)
 
+// Input buffer length; samples are written linearly and the most recent
+// WLANFRAMESYNC_BUFFER_HISTORY samples are moved back to the start once
+// the end is reached. The history must hold the long sequence search
+// window (WLANFRAMESYNC_S1_SEARCH_LEN) as well as the most recent symbol
+// plus the processing delay following the search (see rxlong0).
+#define WLANFRAMESYNC_BUFFER_LEN        (1024)
+#define WLANFRAMESYNC_BUFFER_HISTORY    (320)
+
 // Thresholds for detecting short sequences
+#define WLANFRAMESYNC_S0_GATE_THRESH    (0.35f)
 #define WLANFRAMESYNC_S0A_ABS_THRESH    (0.35f)
 //#define WLANFRAMESYNC_S0B_ABS_THRESH    (0.5f)
 
+// Long sequence search: S1[a] starts on the 16-sample grid established by
+// the short sequence, between WLANFRAMESYNC_S1_GRID_MIN and _MAX grid steps
+// past the end of the last short sequence window (see rxshort1). The search
+// waits for WLANFRAMESYNC_S1_WAIT samples so that both long sequences of
+// the latest candidate (plus timing look-ahead) are in the input buffer,
+// and runs over the last WLANFRAMESYNC_S1_SEARCH_LEN of them.
+#define WLANFRAMESYNC_S1_GRID_MIN       (2)
+#define WLANFRAMESYNC_S1_GRID_MAX       (10)
+#define WLANFRAMESYNC_S1_WAIT           (16*(WLANFRAMESYNC_S1_GRID_MAX+4) + 64 + 2)
+#define WLANFRAMESYNC_S1_SEARCH_LEN     (WLANFRAMESYNC_S1_WAIT - 16*WLANFRAMESYNC_S1_GRID_MIN + 6)
+
 // Thresholds for detecting first long sequence, S1[a]
+#define WLANFRAMESYNC_S1A_XCORR_THRESH  (0.4f)
 #define WLANFRAMESYNC_S1A_ABS_THRESH    (0.35f)
 #define WLANFRAMESYNC_S1A_ARG_THRESH    (0.3f)
 
@@ -47,30 +68,132 @@
 #define WLANFRAMESYNC_S1B_ABS_THRESH    (0.35f)
 #define WLANFRAMESYNC_S1B_ARG_THRESH    (0.3f)
 
+// Detection threshold adaptation: the S0[a] threshold is raised by one
+// step on each false alarm and lowered by a fraction (the target rate) of
+// a step every search window, settling where false alarms occur at the
+// target rate; it never drops below WLANFRAMESYNC_S0A_ABS_THRESH
+#define WLANFRAMESYNC_S0A_ABS_THRESH_MAX    (0.5f)
+#define WLANFRAMESYNC_THRESH_STEP           (0.01f)
+#define WLANFRAMESYNC_FALSE_ALARM_RATE      (1e-3f)
+
+// Noise floor: smoothing factor for the per-sample energy of search
+// windows failing the gate, the number of initial windows the floor is
+// seeded from (their minimum), and the margin (linear) a window's energy
+// must exceed the noise floor by to be searched
+#define WLANFRAMESYNC_NOISE_ALPHA       (0.03f)
+#define WLANFRAMESYNC_NOISE_INIT        (16)
+#define WLANFRAMESYNC_NOISE_MARGIN      (1.5f)
+
+// Equalizer polynomial order {1,2,3}
+#define WLANFRAMESYNC_EQGAIN_ORDER      (2)
+
+// Reference gain tables: conj(S)/|S|^2 = conj(S) for the short and long
+// sequences with the nominal gain folded in, split into real/imaginary
+// arrays. The short sequence table is indexed by folded 16-point bin k
+// (subcarrier 4k); the long sequence is real so only its real part is
+// stored. NULL subcarriers are zero so the loops need no branches.
+#define S0G (0.707110f*0.054127f)   // |S0| * sqrt(12)/64
+#define S1G (0.11267f)              // sqrt(52)/64
+static const float wlanframesync_S0c_re[16] = {
+    0.0f,  -S0G,  -S0G,   S0G,   S0G,   S0G,   S0G,  0.0f,
+    0.0f,  0.0f,   S0G,  -S0G,   S0G,  -S0G,  -S0G,   S0G};
+static const float wlanframesync_S0c_im[16] = {
+    0.0f,   S0G,   S0G,  -S0G,  -S0G,  -S0G,  -S0G,  0.0f,
+    0.0f,  0.0f,  -S0G,   S0G,  -S0G,   S0G,   S0G,  -S0G};
+static const float wlanframesync_S1c[64] = {
+    0.0f,   S1G,  -S1G,  -S1G,   S1G,   S1G,  -S1G,   S1G,
+    -S1G,   S1G,  -S1G,  -S1G,  -S1G,  -S1G,  -S1G,   S1G,
+     S1G,  -S1G,  -S1G,   S1G,  -S1G,   S1G,  -S1G,   S1G,
+     S1G,   S1G,   S1G,  0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+    0.0f,  0.0f,  0.0f,  0.0f,  0.0f,  0.0f,   S1G,   S1G,
+    -S1G,  -S1G,   S1G,   S1G,  -S1G,   S1G,  -S1G,   S1G,
+     S1G,   S1G,   S1G,   S1G,   S1G,  -S1G,  -S1G,   S1G,
+     S1G,  -S1G,   S1G,  -S1G,   S1G,   S1G,   S1G,   S1G};
+#undef S0G
+#undef S1G
+
+// indexable table of auto-generated equalizer fit tables
+const float * wlan_eqfit_gentab[4] = {
+    NULL,
+    wlan_eqfit_P1,
+    wlan_eqfit_P2,
+    wlan_eqfit_P3};
+
+// Object layout: the fields touched on every OFDM symbol are kept
+// together at the start of the (64-byte aligned) object, ahead of the
+// acquisition and frame-level state, which is only touched while
+// acquiring or once per frame. Per instance the hot block takes
+//   transform buffers x, X             1024 bytes
+//   channel correction R (split)        512 bytes
+//   per-symbol state                    192 bytes
+// i.e. 27 cache lines, plus the most recent symbol and processing delay
+// (at most 211 samples, 1688 bytes) of the input buffer, so a few dozen
+// instances can share a core's L1/L2. Transform plans and twiddle
+// factors are shared by all instances (see wlan_fft.c). The object,
+// input buffer, transform object and message buffers are placed in a
+// single block (see wlanframesync_sizeof()).
 struct wlanframesync_s {
+    //
+    // hot: per-symbol state
+    //
+
+    // transform buffers
+    float complex x[64] __attribute__((aligned(64))); // time-domain buffer
+    float complex X[64];    // frequency-domain buffer
+
+    // complex channel correction (composite), split real/imaginary
+    float R_re[64];
+    float R_im[64];
+
+    // counters/states
+    enum {
+        WLANFRAMESYNC_STATE_SEEKPLCP=0, // seek initial PLCP
+        WLANFRAMESYNC_STATE_RXSHORT0,   // receive first 'short' sequence
+        WLANFRAMESYNC_STATE_RXSHORT1,   // receive second 'short' sequence
+        WLANFRAMESYNC_STATE_RXLONG0,    // receive first 'long' sequence
+        WLANFRAMESYNC_STATE_RXLONG1,    // receive second 'long' sequence
+        WLANFRAMESYNC_STATE_RXSIGNAL,   // receive SIGNAL field
+        WLANFRAMESYNC_STATE_RXDATA,     // receive DATA field
+    } state;
+    signed int timer;                   // sample timer
+    unsigned int buffer_index;          // write position in input buffer
+    unsigned int delay;                 // samples received past the symbol being processed
+    unsigned int num_symbols;           // number of received OFDM data symbols
+    unsigned int nsym;                  // number of OFDM symbols in the DATA field
+    unsigned int mod_scheme;            // DATA field (de)modulation scheme
+    unsigned int nbpsc;                 // number of bits per subcarrier (modulation depth)
+    unsigned int bytes_per_symbol;      // number of encoded data bytes per OFDM symbol
+    float phi_prime;                    // stored pilot phase
+
+    // carrier oscillator (phase at the end of the input buffer)
+    float nco_phase;                    // phase [radians], in [-pi,pi]
+    float nco_freq;                     // frequency [radians/sample]
+
+    // objects and arrays
+    float complex * buffer;             // input sequence buffer (linear)
+    wlan_fft fft;                       // fft object
+    struct wlan_lfsr_s ms_pilot;        // pilot sequence generator
+    unsigned char * msg_enc;            // encoded message (DATA field), sized for max_length
+    unsigned char   modem_syms[48];     // modem symbols
+
+    //
+    // cold: acquisition and frame-level state
+    //
+
     // callback
-    wlanframesync_callback callback;
+    wlanframesync_callback callback __attribute__((aligned(64)));
     void * userdata;
 
     // options
     unsigned int rate;      // primitive data rate
     unsigned int length;    // original data length (bytes)
     unsigned int seed;      // data scrambler seed
-
-    // transform object
-    FFT_PLAN fft;           // ifft object
-    float complex * X;      // frequency-domain buffer
-    float complex * x;      // time-domain buffer
-    windowcf input_buffer;  // input sequence buffer
-
-    // synchronizer objects
-    nco_crcf nco_rx;        // numerically-controlled oscillator
-    wlan_lfsr ms_pilot;     // pilot sequence generator
-    unsigned int mod_scheme;// DATA field (de)modulation scheme
-    float phi_prime;        // stored pilot phase
+    unsigned int max_length;// maximum data length accepted (bytes)
 
     // gain arrays
-    float g0;                       // nominal gain
+    float g0;                       // nominal gain (input sample units)
+    float sample_scale;             // input sample unit relative to full
+                                    // scale (set by execute() method)
     float complex G0a[64], G0b[64]; // complex channel gain (short sequences)
     float complex s0a_hat;          // first 'short' sequence statistic
     float complex s0b_hat;          // second 'short' sequence statistic
@@ -78,41 +201,39 @@ struct wlanframesync_s {
     float complex s1a_hat;          // first 'long' sequence statistic
     float complex s1b_hat;          // second 'long' sequence statistic
     float complex G[64];            // complex channel gain (composite)
-    float complex R[64];            // complex channel correction (composite)
 
     // lengths
     unsigned int ndbps;             // number of data bits per OFDM symbol
     unsigned int ncbps;             // number of coded bits per OFDM symbol
-    unsigned int nbpsc;             // number of bits per subcarrier (modulation depth)
     unsigned int dec_msg_len;       // length of decoded message (bytes)
     unsigned int enc_msg_len;       // length of encoded message (bytes)
-    unsigned int nsym;              // number of OFDM symbols in the DATA field
     unsigned int ndata;             // number of bits in the DATA field
     unsigned int npad;              // number of pad bits
-    unsigned int bytes_per_symbol;  // number of encoded data bytes per OFDM symbol
 
     // data arrays
     unsigned char   signal_int[6];  // interleaved message (SIGNAL field)
     unsigned char   signal_enc[6];  // encoded message (SIGNAL field)
     unsigned char   signal_dec[3];  // decoded message (SIGNAL field)
-    unsigned char * msg_enc;        // encoded message (DATA field)
-    unsigned char * msg_dec;        // decoded message (DATA field)
-    unsigned char   modem_syms[48]; // modem symbols
+    unsigned char * msg_dec;        // decoded message (DATA field), sized for max_length
     int signal_valid;               // SIGNAL field decoded properly?
     
-    // counters/states
-    enum {
-        WLANFRAMESYNC_STATE_SEEKPLCP=0, // seek initial PLCP
-        WLANFRAMESYNC_STATE_RXSHORT0,   // receive first 'short' sequence
-        WLANFRAMESYNC_STATE_RXSHORT1,   // receive second 'short' sequence
-        WLANFRAMESYNC_STATE_RXLONG0,    // receive first 'long' sequence
-        WLANFRAMESYNC_STATE_RXLONG1,    // receive second 'long' sequence
-        WLANFRAMESYNC_STATE_RXSIGNAL,   // receive SIGNAL field
-        WLANFRAMESYNC_STATE_RXDATA,     // receive DATA field
-    } state;
-    signed int timer;                   // sample timer
-    signed int block_counter;           // count number of S1 symbol hypothesis tests
-    unsigned int num_symbols;           // number of received OFDM data symbols
+    float s1_lead;                      // FFT window lead into the long sequence cyclic
+                                        // prefix: timing backoff plus fractional timing
+                                        // estimate [samples]
+
+    // detection threshold/noise floor (persist across frames)
+    float noise_floor;                  // noise floor estimate (energy per sample)
+    unsigned int noise_count;           // windows seeding noise floor (saturates)
+    float s0a_thresh;                   // S0[a] detection threshold
+    float pfa;                          // target false-alarm rate (per search window)
+
+    // detection statistics
+    unsigned long int num_detections;   // number of S0[a] detections
+    unsigned long int num_s1_timeouts;  // number of failed S1[a] searches
+    unsigned long int num_signal_errors;// number of invalid SIGNAL fields
+
+    // input samples consumed since initialization (frame position)
+    unsigned long int num_samples;
 
 #if DEBUG_WLANFRAMESYNC
     // debugging structures
@@ -128,38 +249,161 @@ struct wlanframesync_s {
 wlanframesync wlanframesync_create(wlanframesync_callback _callback,
                                    void *                 _userdata)
 {
-    // allocate main object memory
-    wlanframesync q = (wlanframesync) malloc(sizeof(struct wlanframesync_s));
+    return wlanframesync_create_max_length(_callback, _userdata, 4095);
+}
+
+// create WLAN framing synchronizer object accepting payloads up to
+// _max_length bytes
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+//  _max_length :   maximum payload length (1-4095)
+wlanframesync wlanframesync_create_max_length(wlanframesync_callback _callback,
+                                              void *                 _userdata,
+                                              unsigned int           _max_length)
+{
+    // allocate object memory (aligned to cache line)
+    void * mem = NULL;
+    if (posix_memalign(&mem, WLAN_MEMORY_ALIGN, wlanframesync_sizeof_max_length(_max_length)) != 0) {
+        fprintf(stderr,"error: wlanframesync_create_max_length(), could not allocate memory\n");
+        exit(1);
+    }
+    return wlanframesync_init_max_length(mem, _callback, _userdata, _max_length);
+}
+
+// destroy WLAN framing synchronizer object
+void wlanframesync_destroy(wlanframesync _q)
+{
+    wlanframesync_fini(_q);
+
+    // free main object memory
+    free(_q);
+}
+
+// compute decoded and encoded message lengths (bytes) of the DATA field
+// for the longest payload accepted, maximized over all rates; padding
+// to whole symbols makes the fastest rates the longest when decoded
+//  _max_length :   maximum payload length (1-4095)
+//  _dec_msg_len:   maximum decoded message length
+//  _enc_msg_len:   maximum encoded message length
+static void wlanframesync_compute_msg_len_max(unsigned int   _max_length,
+                                              unsigned int * _dec_msg_len,
+                                              unsigned int * _enc_msg_len)
+{
+    // validate input
+    if (_max_length == 0 || _max_length > 4095) {
+        fprintf(stderr,"error: wlanframesync_compute_msg_len_max(), invalid data length\n");
+        exit(1);
+    }
+
+    *_dec_msg_len = 0;
+    *_enc_msg_len = 0;
+    unsigned int r;
+    for (r=0; r<8; r++) {
+        unsigned int ndbps = wlanframe_ratetab[r].ndbps;
+        unsigned int nsym  = (16 + 8*_max_length + 6 + ndbps - 1) / ndbps;
+        unsigned int dec_msg_len = (nsym * ndbps + 7) / 8;
+        unsigned int enc_msg_len = wlan_packet_compute_enc_msg_len(r, _max_length);
+        if (dec_msg_len > *_dec_msg_len) *_dec_msg_len = dec_msg_len;
+        if (enc_msg_len > *_enc_msg_len) *_enc_msg_len = enc_msg_len;
+    }
+}
+
+// get size of WLAN framing synchronizer object block [bytes]
+size_t wlanframesync_sizeof(void)
+{
+    return wlanframesync_sizeof_max_length(4095);
+}
+
+// get size of WLAN framing synchronizer object block [bytes] accepting
+// payloads up to _max_length bytes
+size_t wlanframesync_sizeof_max_length(unsigned int _max_length)
+{
+    unsigned int dec_msg_len;
+    unsigned int enc_msg_len;
+    wlanframesync_compute_msg_len_max(_max_length, &dec_msg_len, &enc_msg_len);
+    return WLAN_ALIGN_SIZE(sizeof(struct wlanframesync_s)) +
+           WLAN_ALIGN_SIZE(WLANFRAMESYNC_BUFFER_LEN*sizeof(float complex)) +
+           WLAN_ALIGN_SIZE(wlan_fft_sizeof()) +
+           WLAN_ALIGN_SIZE(dec_msg_len) +
+           WLAN_ALIGN_SIZE(enc_msg_len);
+}
+
+// initialize WLAN framing synchronizer object in caller-provided memory
+//  _mem        :   object memory [size: wlanframesync_sizeof() bytes,
+//                  aligned to WLAN_MEMORY_ALIGN]
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+wlanframesync wlanframesync_init(void *                 _mem,
+                                 wlanframesync_callback _callback,
+                                 void *                 _userdata)
+{
+    return wlanframesync_init_max_length(_mem, _callback, _userdata, 4095);
+}
+
+// initialize WLAN framing synchronizer object in caller-provided memory,
+// accepting payloads up to _max_length bytes
+//  _mem        :   object memory [size: wlanframesync_sizeof_max_length()
+//                  bytes, aligned to WLAN_MEMORY_ALIGN]
+//  _callback   :   user-defined callback function
+//  _userdata   :   user-defined data structure
+//  _max_length :   maximum payload length (1-4095)
+wlanframesync wlanframesync_init_max_length(void *                 _mem,
+                                            wlanframesync_callback _callback,
+                                            void *                 _userdata,
+                                            unsigned int           _max_length)
+{
+    // validate input
+    if (_mem == NULL) {
+        fprintf(stderr,"error: wlanframesync_init_max_length(), memory is NULL\n");
+        exit(1);
+    } else if ((uintptr_t)_mem % WLAN_MEMORY_ALIGN) {
+        fprintf(stderr,"error: wlanframesync_init_max_length(), memory must be aligned to %u bytes\n", WLAN_MEMORY_ALIGN);
+        exit(1);
+    }
+
+    // message buffer lengths (validates _max_length)
+    unsigned int dec_msg_max;
+    unsigned int enc_msg_max;
+    wlanframesync_compute_msg_len_max(_max_length, &dec_msg_max, &enc_msg_max);
+
+    // clear block and partition: object, input buffer, transform,
+    // decoded and encoded message buffers
+    memset(_mem, 0x00, wlanframesync_sizeof_max_length(_max_length));
+    unsigned char * p = (unsigned char*) _mem;
+    wlanframesync q = (wlanframesync) p;
+    p += WLAN_ALIGN_SIZE(sizeof(struct wlanframesync_s));
+    q->buffer = (float complex*) p;
+    p += WLAN_ALIGN_SIZE(WLANFRAMESYNC_BUFFER_LEN*sizeof(float complex));
+    q->fft = wlan_fft_init(p, q->x, q->X, WLAN_FFT_FORWARD, 0);
+    p += WLAN_ALIGN_SIZE(wlan_fft_sizeof());
+    q->msg_dec = p;
+    p += WLAN_ALIGN_SIZE(dec_msg_max);
+    q->msg_enc = p;
     
     // set callback data
     q->callback = _callback;
     q->userdata = _userdata;
 
-    // create transform object
-    q->X = (float complex*) malloc(64*sizeof(float complex));
-    q->x = (float complex*) malloc(64*sizeof(float complex));
-    q->fft = FFT_CREATE_PLAN(64, q->x, q->X, FFT_DIR_FORWARD, FFT_METHOD);
- 
-    // create input buffer the length of the transform
-    q->input_buffer = windowcf_create(80);
-
     // synchronizer objects
-    q->nco_rx = nco_crcf_create(LIQUID_VCO);
-    q->ms_pilot = wlan_lfsr_create(7, 0x91, 0x7f);
+    wlan_lfsr_init(&q->ms_pilot, 7, 0x91, 0x7f);
     q->mod_scheme = WLAN_MODEM_BPSK;
 
     // set initial properties
-    q->rate   = WLANFRAME_RATE_6;
-    q->length = 100;
-    q->seed   = 0x5d;
-
-    // allocate memory for encoded message
-    q->enc_msg_len = wlan_packet_compute_enc_msg_len(q->rate, q->length);
-    q->msg_enc = (unsigned char*) malloc(q->enc_msg_len*sizeof(unsigned char));
-
-    // allocate memory for decoded message
-    q->dec_msg_len = 1;
-    q->msg_dec = (unsigned char*) malloc(q->dec_msg_len*sizeof(unsigned char));
+    q->rate       = WLANFRAME_RATE_6;
+    q->length     = 100;
+    q->seed       = 0x5d;
+    q->max_length = _max_length;
+
+    // set detection threshold, noise floor unknown
+    q->noise_floor       = 0.0f;
+    q->noise_count       = 0;
+    q->s0a_thresh        = WLANFRAMESYNC_S0A_ABS_THRESH;
+    q->pfa               = WLANFRAMESYNC_FALSE_ALARM_RATE;
+    q->num_detections    = 0;
+    q->num_s1_timeouts   = 0;
+    q->num_signal_errors = 0;
+    q->num_samples       = 0;
+    q->sample_scale      = 1.0f;
 
     // reset object
     wlanframesync_reset(q);
@@ -175,8 +419,9 @@ wlanframesync wlanframesync_create(wlanframesync_callback _callback,
     return q;
 }
 
-// destroy WLAN framing synchronizer object
-void wlanframesync_destroy(wlanframesync _q)
+// release WLAN framing synchronizer object resources without freeing the
+// object memory
+void wlanframesync_fini(wlanframesync _q)
 {
 #if DEBUG_WLANFRAMESYNC
     // free debugging objects if necessary
@@ -184,37 +429,32 @@ void wlanframesync_destroy(wlanframesync _q)
     if (_q->debug_framesyms != NULL) windowcf_destroy(_q->debug_framesyms);
 #endif
 
-    // free transform object
-    windowcf_destroy(_q->input_buffer);
-    free(_q->X);
-    free(_q->x);
-    FFT_DESTROY_PLAN(_q->fft);
-    
-    // destroy synchronizer objects
-    nco_crcf_destroy(_q->nco_rx);       // numerically-controlled oscillator
-    wlan_lfsr_destroy(_q->ms_pilot);    // pilot sequence generator
-
-    // free memory for encoded message
-    free(_q->msg_enc);
-
-    // free main object memory
-    free(_q);
+    // release transform object
+    wlan_fft_fini(_q->fft);
 }
 
 // print WLAN framing synchronizer object internals
 void wlanframesync_print(wlanframesync _q)
 {
     printf("wlanframesync:\n");
+    printf("    noise floor     :   %8.2f dB\n", wlanframesync_get_noise_floor(_q));
+    printf("    threshold       :   %8.4f (false alarm rate %g)\n", _q->s0a_thresh, _q->pfa);
+    printf("    detections      :   %lu\n", _q->num_detections);
+    printf("    S1 time-outs    :   %lu\n", _q->num_s1_timeouts);
+    printf("    SIGNAL errors   :   %lu\n", _q->num_signal_errors);
 }
 
 // reset WLAN framing synchronizer object internal state
 void wlanframesync_reset(wlanframesync _q)
 {
     // clear buffer
-    windowcf_reset(_q->input_buffer);
+    memset(_q->buffer, 0x00, 80*sizeof(float complex));
+    _q->buffer_index = 80;
+    _q->delay = 0;
 
-    // reset NCO object
-    nco_crcf_reset(_q->nco_rx);
+    // reset carrier oscillator
+    _q->nco_phase = 0.0f;
+    _q->nco_freq  = 0.0f;
 
     // reset timers/state
     _q->state = WLANFRAMESYNC_STATE_SEEKPLCP;
@@ -223,7 +463,7 @@ void wlanframesync_reset(wlanframesync _q)
     _q->phi_prime = 0.0f;   // reset phase offset estimate
 
     // reset pilot sequence generator
-    wlan_lfsr_reset(_q->ms_pilot);
+    wlan_lfsr_reset(&_q->ms_pilot);
 }
 
 // execute framing synchronizer on input buffer
@@ -234,26 +474,170 @@ void wlanframesync_execute(wlanframesync          _q,
                            liquid_float_complex * _buffer,
                            unsigned int           _n)
 {
-    unsigned int i;
-    float complex x;
-    for (i=0; i<_n; i++) {
-        x = _buffer[i];
+    wlanframesync_set_sample_scale(_q, 1.0f);
+    wlanframesync_execute_format(_q, _buffer, WLAN_IQ_CF32, _n);
+}
 
-        // correct for carrier frequency offset (only if not in
-        // initial 'seek PLCP' state)
-        if (_q->state != WLANFRAMESYNC_STATE_SEEKPLCP) {
-            nco_crcf_mix_down(_q->nco_rx, x, &x);
-            nco_crcf_step(_q->nco_rx);
+// execute framing synchronizer on interleaved 16-bit integer samples
+// (full scale 32768)
+//  _q      :   framing synchronizer object
+//  _buffer :   input buffer [size: 2*_n x 1]
+//  _n      :   number of complex samples
+void wlanframesync_execute_sc16(wlanframesync   _q,
+                                const int16_t * _buffer,
+                                unsigned int    _n)
+{
+    wlanframesync_set_sample_scale(_q, 1.0f/32768.0f);
+    wlanframesync_execute_format(_q, _buffer, WLAN_IQ_CI16, _n);
+}
+
+// execute framing synchronizer on interleaved 8-bit integer samples
+// (full scale 128)
+//  _q      :   framing synchronizer object
+//  _buffer :   input buffer [size: 2*_n x 1]
+//  _n      :   number of complex samples
+void wlanframesync_execute_sc8(wlanframesync  _q,
+                               const int8_t * _buffer,
+                               unsigned int   _n)
+{
+    wlanframesync_set_sample_scale(_q, 1.0f/128.0f);
+    wlanframesync_execute_format(_q, _buffer, WLAN_IQ_CI8, _n);
+}
+
+// get receiver RSSI
+float wlanframesync_get_rssi(wlanframesync _q)
+{
+    return 10*log10f(_q->g0) - 20*log10f(_q->sample_scale);
+}
+
+// get receiver carrier frequency offset estimate
+float wlanframesync_get_cfo(wlanframesync _q)
+{
+    return 0.0f;
+}
+
+// get noise floor estimate [dB]
+float wlanframesync_get_noise_floor(wlanframesync _q)
+{
+    return 10*log10f(_q->noise_floor*_q->sample_scale*_q->sample_scale + 1e-12f);
+}
+
+// get S0[a] detection threshold
+float wlanframesync_get_threshold(wlanframesync _q)
+{
+    return _q->s0a_thresh;
+}
+
+// get number of S0[a] detections
+unsigned long int wlanframesync_get_num_detections(wlanframesync _q)
+{
+    return _q->num_detections;
+}
+
+// get number of detections failing the S1[a] search
+unsigned long int wlanframesync_get_num_s1_timeouts(wlanframesync _q)
+{
+    return _q->num_s1_timeouts;
+}
+
+// get number of detections failing to decode the SIGNAL field
+unsigned long int wlanframesync_get_num_signal_errors(wlanframesync _q)
+{
+    return _q->num_signal_errors;
+}
+
+// get number of input samples processed since the object was created
+// (not cleared by wlanframesync_reset()); within a callback this is the
+// position just past the last sample of the frame
+unsigned long int wlanframesync_get_num_samples(wlanframesync _q)
+{
+    return _q->num_samples - _q->delay;
+}
+
+// set target false-alarm rate
+//  _q      :   framing synchronizer object
+//  _pfa    :   false alarms per search window, 0 <= _pfa < 1
+void wlanframesync_set_false_alarm_rate(wlanframesync _q,
+                                        float         _pfa)
+{
+    if (_pfa < 0.0f || _pfa >= 1.0f) {
+        fprintf(stderr,"error: wlanframesync_set_false_alarm_rate(), rate must be in [0,1)\n");
+        exit(1);
+    }
+
+    _q->pfa = _pfa;
+
+    // hold threshold at its nominal value if adaptation is disabled
+    if (_q->pfa == 0.0f)
+        _q->s0a_thresh = WLANFRAMESYNC_S0A_ABS_THRESH;
+}
+
+
+//
+// internal methods
+//
+
+// execute framing synchronizer on input buffer of given sample format
+//  _q      :   framing synchronizer object
+//  _buffer :   input buffer [size: _n complex samples]
+//  _format :   input sample format (WLAN_IQ_CF32, WLAN_IQ_CI16, WLAN_IQ_CI8)
+//  _n      :   number of complex samples
+void wlanframesync_execute_format(wlanframesync _q,
+                                  const void *  _buffer,
+                                  int           _format,
+                                  unsigned int  _n)
+{
+    // number of samples each state accumulates before acting on the
+    // input buffer (indexed by state)
+    static const signed int period[7] = {64, 16, 16, WLANFRAMESYNC_S1_WAIT, 64, 80, 80};
+
+    unsigned int i = 0;
+    while (i < _n) {
+        // consume as many samples as the current state needs
+        unsigned int k = period[_q->state] - _q->timer;
+        if (k > _n - i) k = _n - i;
+
+        // move most recent samples to start of input buffer if the block
+        // won't fit
+        if (_q->buffer_index + k > WLANFRAMESYNC_BUFFER_LEN) {
+            memmove(_q->buffer,
+                    &_q->buffer[_q->buffer_index - WLANFRAMESYNC_BUFFER_HISTORY],
+                    WLANFRAMESYNC_BUFFER_HISTORY*sizeof(float complex));
+            _q->buffer_index = WLANFRAMESYNC_BUFFER_HISTORY;
         }
+        float complex * y = &_q->buffer[_q->buffer_index];
 
-        // save input sample to buffer
-        windowcf_push(_q->input_buffer,x);
+        // save block to input buffer, converting integer samples (their
+        // scale is carried by the gain, see wlanframesync_set_sample_scale());
+        // carrier frequency offset is only corrected on the samples handed
+        // to the transforms (see wlanframesync_mix_down()), so here just
+        // advance the oscillator phase across the block (only if not in
+        // initial 'seek PLCP' state)
+        switch (_format) {
+        case WLAN_IQ_CI16:
+            liquid_wlan_convert_ci16((const int16_t*)_buffer + 2*i, 2*k, 1.0f, (float*)y);
+            break;
+        case WLAN_IQ_CI8:
+            liquid_wlan_convert_ci8((const int8_t*)_buffer + 2*i, 2*k, 1.0f, (float*)y);
+            break;
+        default:
+            memmove(y, (const float complex*)_buffer + i, k*sizeof(float complex));
+        }
+        if (_q->state != WLANFRAMESYNC_STATE_SEEKPLCP)
+            wlanframesync_nco_step(_q, k);
 
 #if DEBUG_WLANFRAMESYNC
-        if (_q->debug_enabled) {
-            windowcf_push(_q->debug_x, x);
-        }
+        if (_q->debug_enabled)
+            windowcf_write(_q->debug_x, y, k);
 #endif
+        _q->buffer_index += k;
+        _q->timer += k;
+        _q->num_samples += k;
+        i         += k;
+
+        // wait for symbol boundary
+        if (_q->timer < period[_q->state])
+            continue;
 
         switch (_q->state) {
         case WLANFRAMESYNC_STATE_SEEKPLCP:
@@ -282,41 +666,78 @@ void wlanframesync_execute(wlanframesync          _q,
             fprintf(stderr,"error: wlanframesync_execute(), invalid state\n");
             exit(1);
         }
-    } // for (i=0; i<_n; i++)
+    }
 }
 
-// get receiver RSSI
-float wlanframesync_get_rssi(wlanframesync _q)
+// set input sample unit relative to full scale. Integer samples enter
+// the input buffer unscaled; since detection and equalization normalize
+// by the gain estimate, only the gain and noise floor (and the samples
+// already buffered) need to follow a change of unit, and the scale
+// itself is only applied when reporting absolute levels
+void wlanframesync_set_sample_scale(wlanframesync _q,
+                                    float         _scale)
 {
-    return 10*log10f(_q->g0);
-}
+    if (_scale == _q->sample_scale)
+        return;
 
-// get receiver carrier frequency offset estimate
-float wlanframesync_get_cfo(wlanframesync _q)
-{
-    return 0.0f;
+    // ratio of old to new unit
+    float r = _q->sample_scale / _scale;
+    unsigned int i;
+    for (i=0; i<_q->buffer_index; i++)
+        _q->buffer[i] *= r;
+    _q->g0          /= r*r;
+    _q->noise_floor *= r*r;
+    _q->sample_scale = _scale;
 }
 
-
-//
-// internal methods
-//
-
 // frame detection
 void wlanframesync_execute_seekplcp(wlanframesync _q)
 {
-    _q->timer++;
-
     // TODO : only check every 100 - 150 (decimates/reduced complexity)
-    if (_q->timer < 64)
-        return;
 
     // reset timer
     _q->timer = 0;
 
     // read contents of input buffer
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
+    float complex * rc = &_q->buffer[_q->buffer_index - 80];
+
+    // relax detection threshold towards its nominal value; false alarms
+    // push it back up (see wlanframesync_false_alarm())
+    if (_q->pfa > 0.0f) {
+        _q->s0a_thresh -= WLANFRAMESYNC_THRESH_STEP * _q->pfa;
+        if (_q->s0a_thresh < WLANFRAMESYNC_S0A_ABS_THRESH)
+            _q->s0a_thresh = WLANFRAMESYNC_S0A_ABS_THRESH;
+    }
+
+    // gate transform-based search on delay-and-correlate metric; this is
+    // near unity only while the (16-periodic) short sequence fills the
+    // window, so an idle channel never reaches the transform
+    float e;
+    if (wlanframesync_S0_autocorr(&rc[16], &e) < WLANFRAMESYNC_S0_GATE_THRESH) {
+        // track noise floor from windows without a short sequence
+        e *= 1.0f / 48.0f;
+        if (_q->noise_count < WLANFRAMESYNC_NOISE_INIT || _q->noise_floor == 0.0f) {
+            // seed from the quietest of the first windows (ignoring
+            // silence), so that starting within a burst does not latch a
+            // high floor
+            if (_q->noise_floor == 0.0f || e < _q->noise_floor)
+                _q->noise_floor = e;
+            if (_q->noise_count < WLANFRAMESYNC_NOISE_INIT)
+                _q->noise_count++;
+        } else {
+            // limit each window to twice the floor: missed frames only
+            // drag it up slowly, while a rising noise level is still
+            // followed (by up to 0.13 dB per window)
+            if (e > 2.0f*_q->noise_floor)
+                e = 2.0f*_q->noise_floor;
+            _q->noise_floor += WLANFRAMESYNC_NOISE_ALPHA*(e - _q->noise_floor);
+        }
+        return;
+    }
+
+    // window must carry energy above the noise floor
+    if (48.0f*WLANFRAMESYNC_NOISE_MARGIN*_q->noise_floor > e)
+        return;
     
     // estimate gain
     // TODO : use gain from result of FFT
@@ -352,7 +773,8 @@ void wlanframesync_execute_seekplcp(wlanframesync _q)
 #endif
 
     // 
-    if (cabsf(s_hat) > WLANFRAMESYNC_S0A_ABS_THRESH) {
+    if (cabsf(s_hat) > _q->s0a_thresh) {
+        _q->num_detections++;
 
         int dt = (int)roundf(tau_hat);
         // set timer appropriately...
@@ -374,16 +796,12 @@ void wlanframesync_execute_seekplcp(wlanframesync _q)
 // frame detection
 void wlanframesync_execute_rxshort0(wlanframesync _q)
 {
-    _q->timer++;
-    if (_q->timer < 16)
-        return;
-
     // reset timer
     _q->timer = 0;
 
-    // read contents of input buffer
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
+    // read contents of input buffer (no carrier offset correction as the
+    // oscillator is not set until the end of rxshort1)
+    float complex * rc = &_q->buffer[_q->buffer_index - 80];
 
     // re-estimate S0 gain
     wlanframesync_estimate_gain_S0(_q, &rc[16], _q->G0a);
@@ -408,16 +826,11 @@ void wlanframesync_execute_rxshort0(wlanframesync _q)
 // frame detection
 void wlanframesync_execute_rxshort1(wlanframesync _q)
 {
-    _q->timer++;
-    if (_q->timer < 16)
-        return;
-
     // reset timer
     _q->timer = 0;
 
     // read contents of input buffer
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
+    float complex * rc = &_q->buffer[_q->buffer_index - 80];
 
     // estimate S0 gain
     wlanframesync_estimate_gain_S0(_q, &rc[16], _q->G0b);
@@ -454,102 +867,134 @@ void wlanframesync_execute_rxshort1(wlanframesync _q)
 #endif
 
     // set NCO frequency
-    nco_crcf_set_frequency(_q->nco_rx, nu_hat);
+    _q->nco_freq = nu_hat;
 
 #if DEBUG_WLANFRAMESYNC_PRINT
     printf("  nu_hat[0]:   %12.8f\n", nu_hat);
     printf("  searching for long sequence...\n");
 #endif
 
-    // set state
+    // set state; the long sequence is searched for once the whole search
+    // window has been received (see wlanframesync_execute_rxlong0())
     _q->state = WLANFRAMESYNC_STATE_RXLONG0;
-    _q->block_counter = 0;
+    _q->timer = 0;
 }
 
 void wlanframesync_execute_rxlong0(wlanframesync _q)
 {
-    // set timer to 16, wait for phase to be relatively small
-    
-    _q->timer++;
-    if (_q->timer < 16)
-        return;
-
     // reset timer
     _q->timer = 0;
 
-    // run fft
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
+    // correct carrier offset on the search window, the last
+    // WLANFRAMESYNC_S1_SEARCH_LEN samples of the input buffer
+    float complex z[WLANFRAMESYNC_S1_SEARCH_LEN];
+    float dtheta = _q->nco_freq;
+    float theta  = _q->nco_phase - (float)(WLANFRAMESYNC_S1_SEARCH_LEN)*dtheta;
+    wlanframesync_derotate(&_q->buffer[_q->buffer_index - WLANFRAMESYNC_S1_SEARCH_LEN],
+                           WLANFRAMESYNC_S1_SEARCH_LEN, theta, dtheta, z);
+
+    // The long sequence starts on the 16-sample grid established by the
+    // short sequence; grid point j of the search falls on z[16j+6].
+    // Cross-correlate against the long sequence in the time domain at each
+    // grid point, scoring each candidate S1[a] position along with S1[b]
+    // 64 samples later so that S1[b] is not mistaken for S1[a].
+    unsigned int j;
+    float rho[WLANFRAMESYNC_S1_GRID_MAX - WLANFRAMESYNC_S1_GRID_MIN + 5];
+    for (j=0; j<WLANFRAMESYNC_S1_GRID_MAX - WLANFRAMESYNC_S1_GRID_MIN + 5; j++)
+        rho[j] = wlanframesync_S1_xcorr(&z[16*j+6]);
+
+    unsigned int j_hat = 0;
+    float score_max = 0.0f;
+    for (j=0; j<=WLANFRAMESYNC_S1_GRID_MAX - WLANFRAMESYNC_S1_GRID_MIN; j++) {
+        if (rho[j] + rho[j+4] > score_max) {
+            score_max = rho[j] + rho[j+4];
+            j_hat     = j;
+        }
+    }
 
-    // estimate S1 gain, adding backoff in gain estimation
-    wlanframesync_estimate_gain_S1(_q, &rc[16-2], _q->G1a);
+    // refine timing around the selected grid point, allowing for one
+    // sample of residual timing error
+    int l;
+    int l_hat = 0;
+    float sc[3];
+    for (l=-1; l<=1; l++) {
+        sc[l+1] = wlanframesync_S1_xcorr(&z[16*j_hat+6+l]) +
+                  wlanframesync_S1_xcorr(&z[16*j_hat+6+l+64]);
+        if (sc[l+1] > sc[l_hat+1])
+            l_hat = l;
+    }
 
-    // compute S1 metrics
-    float complex s_hat;
-    wlanframesync_S1_metrics(_q, _q->G1a, &s_hat);
-    s_hat *= _q->g0;    // scale output by raw gain estimate
+    // position of S1[a] in search window
+    unsigned int p = 16*j_hat + 6 + l_hat;
 
-    // rotate by complex phasor relative to timing backoff
-    //s_hat *= cexpf(_Complex_I * 2.0f * 2.0f * M_PI / 64.0f);
-    s_hat *= cexpf(_Complex_I * 0.19635f);
+#if DEBUG_WLANFRAMESYNC_PRINT
+    printf("    rho       :   %12.8f (grid %u, lag %d)\n",
+            0.5f*sc[l_hat+1], j_hat + WLANFRAMESYNC_S1_GRID_MIN, l_hat);
+#endif
+
+    if (0.5f*sc[l_hat+1] > WLANFRAMESYNC_S1A_XCORR_THRESH) {
+        // estimate S1 gain at located boundary, adding backoff in gain
+        // estimation
+        wlanframesync_estimate_gain_S1(_q, &z[p-2], _q->G1a);
+
+        // compute S1 metrics
+        float complex s_hat;
+        wlanframesync_S1_metrics(_q, _q->G1a, &s_hat);
+        s_hat *= _q->g0;    // scale output by raw gain estimate
+
+        // rotate by complex phasor relative to timing backoff
+        s_hat *= cexpf(_Complex_I * 2.0f * 2.0f * M_PI / 64.0f);
 
-    // save first 'long' symbol statistic
-    _q->s1a_hat = s_hat;
+        // save first 'long' symbol statistic
+        _q->s1a_hat = s_hat;
+
+        float s_hat_abs = cabsf(s_hat);
+        float s_hat_arg = cargf(s_hat);
+
+        // remaining (sub-sample) timing offset from phase slope gives the
+        // lead of the transform window into the long sequence
+        _q->s1_lead = 2.0f - s_hat_arg*64.0f/(2*M_PI);
 
 #if DEBUG_WLANFRAMESYNC_PRINT
-    printf("    s_hat[%2u] :   %12.8f <%12.8f>\n", _q->block_counter, cabsf(s_hat), cargf(s_hat));
+        printf("    s_hat     :   %12.8f <%12.8f>\n", s_hat_abs, s_hat_arg);
+        printf("    lead      :   %12.8f\n", _q->s1_lead);
 #endif
 
-    float s_hat_abs = cabsf(s_hat);
-    float s_hat_arg = cargf(s_hat);
-    if (s_hat_arg >  M_PI) s_hat_arg -= 2.0f*M_PI;
-    if (s_hat_arg < -M_PI) s_hat_arg += 2.0f*M_PI;
-    
-    // check conditions for s_hat:
-    //  1. magnitude should be large (near unity) when aligned
-    //  2. phase should be very near zero (time aligned)
-    if (s_hat_abs        > WLANFRAMESYNC_S1A_ABS_THRESH &&
-        fabsf(s_hat_arg) < WLANFRAMESYNC_S1A_ARG_THRESH)
-    {
+        // confirm alignment:
+        //  1. magnitude should be large (near unity) when aligned
+        //  2. phase should be very near zero (time aligned)
+        if (s_hat_abs        > WLANFRAMESYNC_S1A_ABS_THRESH &&
+            fabsf(s_hat_arg) < WLANFRAMESYNC_S1A_ARG_THRESH)
+        {
 #if DEBUG_WLANFRAMESYNC_PRINT
-        printf("    acquisition S1[a]\n");
+            printf("    acquisition S1[a]\n");
 #endif
-        
-        // set state
-        _q->state = WLANFRAMESYNC_STATE_RXLONG1;
-
-        // reset timer
-        _q->timer = 0;
+            // S1[b] is already in the input buffer: process it now, and
+            // hold the following symbols back by the samples received
+            // past its end (see wlanframesync_mix_down())
+            _q->delay = WLANFRAMESYNC_S1_SEARCH_LEN - (p + 128);
+            wlanframesync_execute_rxlong1(_q);
+            return;
+        }
     }
 
-    // eventually time-out
-    _q->block_counter++;
-
-    // TODO: determine appropriate number here
-    if (_q->block_counter == 32) {
 #if DEBUG_WLANFRAMESYNC_PRINT
-        printf("    timeout for S1[a]\n");
+    printf("    S1[a] not found\n");
 #endif
-        // set state
-        _q->state = WLANFRAMESYNC_STATE_SEEKPLCP;
+    _q->num_s1_timeouts++;
+    wlanframesync_false_alarm(_q);
 
-        // reset timer
-        _q->timer = 0;
-    }
+    // set state
+    _q->state = WLANFRAMESYNC_STATE_SEEKPLCP;
 }
 
 void wlanframesync_execute_rxlong1(wlanframesync _q)
 {
-    _q->timer++;
-    if (_q->timer < 64)
-        return;
-
-    // run fft
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
+    // correct carrier offset on transform input, adding backoff
+    wlanframesync_mix_down(_q, 16-2, 64, _q->x);
 
-    // estimate S1 gain, adding backoff in gain estimation
-    wlanframesync_estimate_gain_S1(_q, &rc[16-2], _q->G1b);
+    // estimate S1 gain
+    wlanframesync_estimate_gain_S1(_q, _q->x, _q->G1b);
 
     // compute S1 metrics
     float complex s_hat;
@@ -557,8 +1002,7 @@ void wlanframesync_execute_rxlong1(wlanframesync _q)
     s_hat *= _q->g0;    // scale output by raw gain estimate
 
     // rotate by complex phasor relative to timing backoff
-    //s_hat *= cexpf(_Complex_I * 2.0f * 2.0f * M_PI / 64.0f);
-    s_hat *= cexpf(_Complex_I * 0.19635f);
+    s_hat *= cexpf(_Complex_I * 2.0f * M_PI * _q->s1_lead / 64.0f);
 
     // save second 'long' symbol statistic
     _q->s1b_hat = s_hat;
@@ -567,7 +1011,7 @@ void wlanframesync_execute_rxlong1(wlanframesync _q)
     //s_hat *= liquid_cexpjf((float)(_q->backoff)*2.0f*M_PI/(float)(_q->M));
 
 #if DEBUG_WLANFRAMESYNC_PRINT
-    printf("    s_hat[%2u] :   %12.8f <%12.8f>\n", _q->block_counter, cabsf(s_hat), cargf(s_hat));
+    printf("    s_hat     :   %12.8f <%12.8f>\n", cabsf(s_hat), cargf(s_hat));
 #endif
 
     // check conditions for s_hat
@@ -588,7 +1032,7 @@ void wlanframesync_execute_rxlong1(wlanframesync _q)
         
         // refine CFO estimate with G1a, G1b and adjust NCO appropriately
         float nu_hat = wlanframesync_estimate_cfo_S1(_q->G1a, _q->G1b);
-        nco_crcf_adjust_frequency(_q->nco_rx, nu_hat);
+        _q->nco_freq += nu_hat;
 #if DEBUG_WLANFRAMESYNC_PRINT
         printf("    nu_hat[1] :   %12.8f\n", nu_hat);
 #endif
@@ -615,20 +1059,14 @@ void wlanframesync_execute_rxlong1(wlanframesync _q)
 // receive the 'SIGNAL' field
 void wlanframesync_execute_rxsignal(wlanframesync _q)
 {
-    _q->timer++;
-    if (_q->timer < 80)
-        return;
-
     // reset timer
     _q->timer = 0;
 
-    // run fft
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
-    memmove(_q->x, &rc[16-2], 64*sizeof(float complex));
+    // correct carrier offset on transform input, adding backoff
+    wlanframesync_mix_down(_q, 16-2, 64, _q->x);
 
     // compute fft, storing result into _q->X
-    FFT_EXECUTE(_q->fft);
+    wlanframesync_fft(_q, _q->x);
   
     // recover symbol, correcting for gain, pilot phase, etc.
     wlanframesync_rxsymbol(_q);
@@ -695,12 +1133,15 @@ void wlanframesync_execute_rxsignal(wlanframesync _q)
 
     // validate proper decoding
     if (!_q->signal_valid) {
+        _q->num_signal_errors++;
+        wlanframesync_false_alarm(_q);
+
         // invoke callback
         if (_q->callback != NULL) {
             // assemble RX vector
             struct wlan_rxvector_s rxvector;
             rxvector.LENGTH     = 0;
-            rxvector.RSSI       = 200 + (unsigned int) (10*log10f(_q->g0));
+            rxvector.RSSI       = 200 + (unsigned int) wlanframesync_get_rssi(_q);
             rxvector.DATARATE   = WLANFRAME_RATE_INVALID;
             rxvector.SERVICE    = 0;
             //int retval =
@@ -719,22 +1160,16 @@ void wlanframesync_execute_rxsignal(wlanframesync _q)
 // receive data symbols
 void wlanframesync_execute_rxdata(wlanframesync _q)
 {
-    _q->timer++;
-    if (_q->timer < 80)
-        return;
-
     //printf("    receiving symbol %u...\n", _q->num_symbols);
 
     // reset timer
     _q->timer = 0;
 
-    // run fft
-    float complex * rc;
-    windowcf_read(_q->input_buffer, &rc);
-    memmove(_q->x, &rc[16-2], 64*sizeof(float complex));
+    // correct carrier offset on transform input, adding backoff
+    wlanframesync_mix_down(_q, 16-2, 64, _q->x);
 
     // compute fft, storing result into _q->X
-    FFT_EXECUTE(_q->fft);
+    wlanframesync_fft(_q, _q->x);
   
     // recover symbol, correcting for gain, pilot phase, etc.
     wlanframesync_rxsymbol(_q);
@@ -785,7 +1220,7 @@ void wlanframesync_execute_rxdata(wlanframesync _q)
         // assemble RX vector
         struct wlan_rxvector_s rxvector;
         rxvector.LENGTH     = _q->length;
-        rxvector.RSSI       = 200 + (unsigned int) (10*log10f(_q->g0));
+        rxvector.RSSI       = 200 + (unsigned int) wlanframesync_get_rssi(_q);
         rxvector.DATARATE   = _q->rate;
         rxvector.SERVICE    = 0;
 
@@ -800,6 +1235,137 @@ void wlanframesync_execute_rxdata(wlanframesync _q)
     }
 }
 
+// advance carrier oscillator phase by _n samples, wrapping it to [-pi,pi]
+void wlanframesync_nco_step(wlanframesync _q,
+                            unsigned int  _n)
+{
+    float phi = _q->nco_phase + (float)_n * _q->nco_freq;
+    while (phi >  M_PI) phi -= 2*M_PI;
+    while (phi < -M_PI) phi += 2*M_PI;
+    _q->nco_phase = phi;
+}
+
+// run forward transform on 64 samples at _x, storing the result in _q->X;
+// the fftw and built-in backends execute directly on _x, the liquid-dsp
+// backend copies the samples into the plan's input buffer (unless
+// already there)
+void wlanframesync_fft(wlanframesync   _q,
+                       float complex * _x)
+{
+    wlan_fft_execute_dft(_q->fft, _x, _q->X);
+}
+
+// correct carrier frequency offset on samples _j through _j+_n-1 of the
+// symbol being processed (rc[_j], ...), which ends _q->delay samples
+// before the end of the input buffer, derotating by the oscillator's
+// phase ramp; the oscillator phase corresponds to the next sample to be
+// written, i.e. rc[80+delay]
+//  _q      :   framing synchronizer object
+//  _j      :   index of first sample in symbol, _j+_n <= 80
+//  _n      :   number of samples (multiple of 4)
+//  _y      :   output array [size: _n x 1]
+void wlanframesync_mix_down(wlanframesync   _q,
+                            unsigned int    _j,
+                            unsigned int    _n,
+                            float complex * _y)
+{
+    float dtheta = _q->nco_freq;
+    float theta  = _q->nco_phase - (float)(80 + _q->delay - _j)*dtheta;
+    wlanframesync_derotate(&_q->buffer[_q->buffer_index - 80 - _q->delay + _j], _n, theta, dtheta, _y);
+}
+
+// apply gain and derotate block by phase ramp, y[i] = x[i] g[i]
+// exp(-j(theta + i*dtheta)), running four independent phasors as in
+// wlanframesync_derotate()
+//  _x      :   input array [size: _n x 1]
+//  _g_re   :   gain array (real) [size: _n x 1]
+//  _g_im   :   gain array (imag) [size: _n x 1]
+//  _n      :   number of samples (multiple of 4)
+//  _theta  :   phase of first sample
+//  _dtheta :   phase step per sample
+//  _y      :   output array [size: _n x 1], may alias _x
+void wlanframesync_derotate_gain(float complex * _x,
+                                 float *         _g_re,
+                                 float *         _g_im,
+                                 unsigned int    _n,
+                                 float           _theta,
+                                 float           _dtheta,
+                                 float complex * _y)
+{
+    float * x = (float*) _x;
+    float * y = (float*) _y;
+
+    // initial phasors and per-step rotation
+    unsigned int i, l;
+    float pr[4], pi[4];
+    for (l=0; l<4; l++) {
+        pr[l] =  cosf(_theta + (float)l*_dtheta);
+        pi[l] = -sinf(_theta + (float)l*_dtheta);
+    }
+    float wr =  cosf(4.0f*_dtheta);
+    float wi = -sinf(4.0f*_dtheta);
+
+    for (i=0; i<2*_n; i+=8) {
+        for (l=0; l<4; l++) {
+            // combined correction c = g * phasor
+            float gr = _g_re[i/2+l];
+            float gi = _g_im[i/2+l];
+            float cr = gr*pr[l] - gi*pi[l];
+            float ci = gr*pi[l] + gi*pr[l];
+
+            float xr = x[i+2*l  ];
+            float xi = x[i+2*l+1];
+            y[i+2*l  ] = xr*cr - xi*ci;
+            y[i+2*l+1] = xr*ci + xi*cr;
+
+            float t = pr[l]*wr - pi[l]*wi;
+            pi[l]   = pr[l]*wi + pi[l]*wr;
+            pr[l]   = t;
+        }
+    }
+}
+
+// derotate block by phase ramp, y[i] = x[i] exp(-j(theta + i*dtheta)),
+// running four independent phasors (each advancing four samples per
+// step) so that the loop body vectorizes
+//  _x      :   input array [size: _n x 1]
+//  _n      :   number of samples (multiple of 4)
+//  _theta  :   phase of first sample
+//  _dtheta :   phase step per sample
+//  _y      :   output array [size: _n x 1]
+void wlanframesync_derotate(float complex * _x,
+                            unsigned int    _n,
+                            float           _theta,
+                            float           _dtheta,
+                            float complex * _y)
+{
+    float * x = (float*) _x;
+    float * y = (float*) _y;
+
+    // initial phasors and per-step rotation
+    unsigned int i, l;
+    float pr[4], pi[4];
+    for (l=0; l<4; l++) {
+        pr[l] =  cosf(_theta + (float)l*_dtheta);
+        pi[l] = -sinf(_theta + (float)l*_dtheta);
+    }
+    float wr =  cosf(4.0f*_dtheta);
+    float wi = -sinf(4.0f*_dtheta);
+
+    for (i=0; i<2*_n; i+=8) {
+        for (l=0; l<4; l++) {
+            float xr = x[i+2*l  ];
+            float xi = x[i+2*l+1];
+            y[i+2*l  ] = xr*pr[l] - xi*pi[l];
+            y[i+2*l+1] = xr*pi[l] + xi*pr[l];
+
+            float t = pr[l]*wr - pi[l]*wi;
+            pi[l]   = pr[l]*wi + pi[l]*wr;
+            pr[l]   = t;
+        }
+    }
+}
+
 // estimate short sequence gain
 //  _q      :   wlanframesync object
 //  _x      :   input array (time), [size: M x 1]
@@ -808,35 +1374,114 @@ void wlanframesync_estimate_gain_S0(wlanframesync _q,
                                     float complex * _x,
                                     float complex * _G)
 {
-    // move input array into fft input buffer
-    memmove(_q->x, _x, 64*sizeof(float complex));
+    // the short sequence only occupies every fourth subcarrier, so rather
+    // than running the full transform compute just those bins from the
+    // 16-point transform of the folded input
+    float complex Y[16];
+    wlanframesync_fft16_folded(_x, Y);
+
+    // compute gain, multiplying by the reference gain table rather than
+    // dividing by S0; bin 4k of the 64-point transform is bin k of the
+    // folded 16-point transform
+    unsigned int i;
+    for (i=0; i<64; i++) _G[i] = 0.0f;
+    for (i=0; i<16; i++) {
+        float yr = crealf(Y[i]);
+        float yi = cimagf(Y[i]);
+        _G[4*i] = (yr*wlanframesync_S0c_re[i] - yi*wlanframesync_S0c_im[i]) +
+                  (yr*wlanframesync_S0c_im[i] + yi*wlanframesync_S0c_re[i])*_Complex_I;
+    }
+}
 
-    // compute fft, storing result into _q->X
-    FFT_EXECUTE(_q->fft);
-    
-    // compute gain, ignoring NULL subcarriers
+// compute every fourth bin of 64-point forward transform by folding input
+// into 16 samples and running radix-4 16-point transform, viz.
+//   Y[k] = sum_{m<16} (x[m] + x[m+16] + x[m+32] + x[m+48]) W16^(mk)
+//        = X[4k]
+//  _x      :   input array (time), [size: 64 x 1]
+//  _Y      :   output array (freq), [size: 16 x 1]
+void wlanframesync_fft16_folded(float complex * _x,
+                                float complex * _Y)
+{
+    // twiddle factors W16^e = exp(-j*2*pi*e/16), e = n2*k1 in [0,9]
+    static const float complex W[10] = {
+         1.000000000f + 0.000000000f*_Complex_I,
+         0.923879533f - 0.382683432f*_Complex_I,
+         0.707106781f - 0.707106781f*_Complex_I,
+         0.382683432f - 0.923879533f*_Complex_I,
+         0.000000000f - 1.000000000f*_Complex_I,
+        -0.382683432f - 0.923879533f*_Complex_I,
+        -0.707106781f - 0.707106781f*_Complex_I,
+        -0.923879533f - 0.382683432f*_Complex_I,
+        -1.000000000f + 0.000000000f*_Complex_I,
+        -0.923879533f + 0.382683432f*_Complex_I};
+
+    // fold input
     unsigned int i;
-    float gain = 0.054127f; // sqrt(12)/64 ; sqrtf(_q->M_S0) / (float)(_q->M);
+    float complex y[16];
+    for (i=0; i<16; i++)
+        y[i] = _x[i] + _x[i+16] + _x[i+32] + _x[i+48];
+
+    // first stage: 4-point transforms over n1 (y[4*n1 + n2]), twiddle
+    float complex B[16];    // B[4*n2 + k1]
+    unsigned int n2;
+    for (n2=0; n2<4; n2++) {
+        float complex a = y[n2   ];
+        float complex b = y[n2+ 4];
+        float complex c = y[n2+ 8];
+        float complex d = y[n2+12];
+        float complex t0 = a + c, t1 = a - c;
+        float complex t2 = b + d, t3 = (b - d)*_Complex_I;
+        B[4*n2+0] =  t0 + t2;
+        B[4*n2+1] = (t1 - t3) * W[  n2];
+        B[4*n2+2] = (t0 - t2) * W[2*n2];
+        B[4*n2+3] = (t1 + t3) * W[3*n2];
+    }
 
-    // clear input
-    for (i=0; i<64; i++) _G[i] = 0.0f;
+    // second stage: 4-point transforms over n2, Y[k1 + 4*k2]
+    unsigned int k1;
+    for (k1=0; k1<4; k1++) {
+        float complex a = B[   k1];
+        float complex b = B[ 4+k1];
+        float complex c = B[ 8+k1];
+        float complex d = B[12+k1];
+        float complex t0 = a + c, t1 = a - c;
+        float complex t2 = b + d, t3 = (b - d)*_Complex_I;
+        _Y[k1   ] = t0 + t2;
+        _Y[k1+ 4] = t1 - t3;
+        _Y[k1+ 8] = t0 - t2;
+        _Y[k1+12] = t1 + t3;
+    }
+}
 
-    // NOTE : if cabsf(_q->S0[i]) == 0 then we can multiply by conjugate
-    //        rather than compute division
-    //_G[i] = _q->X[i] / _q->S0[i];
-    _G[40] = _q->X[40] * conjf(wlanframe_S0[40]) * gain;
-    _G[44] = _q->X[44] * conjf(wlanframe_S0[44]) * gain;
-    _G[48] = _q->X[48] * conjf(wlanframe_S0[48]) * gain;
-    _G[52] = _q->X[52] * conjf(wlanframe_S0[52]) * gain;
-    _G[56] = _q->X[56] * conjf(wlanframe_S0[56]) * gain;
-    _G[60] = _q->X[60] * conjf(wlanframe_S0[60]) * gain;
-    //
-    _G[ 4] = _q->X[ 4] * conjf(wlanframe_S0[ 4]) * gain;
-    _G[ 8] = _q->X[ 8] * conjf(wlanframe_S0[ 8]) * gain;
-    _G[12] = _q->X[12] * conjf(wlanframe_S0[12]) * gain;
-    _G[16] = _q->X[16] * conjf(wlanframe_S0[16]) * gain;
-    _G[20] = _q->X[20] * conjf(wlanframe_S0[20]) * gain;
-    _G[24] = _q->X[24] * conjf(wlanframe_S0[24]) * gain;
+// compute delay-and-correlate (Schmidl-Cox) metric at lag 16 over
+// window, normalized by energy of the delayed samples
+//  _x      :   input array (time), [size: 64 x 1]
+//  _e      :   output energy of the delayed samples (48 samples)
+float wlanframesync_S0_autocorr(float complex * _x,
+                                float *         _e)
+{
+    float complex p = 0.0f; // lag-16 autocorrelation
+    float         e = 0.0f; // energy
+    unsigned int i;
+    for (i=0; i<48; i++) {
+        p += _x[i+16] * conjf(_x[i]);
+        e += crealf(_x[i])*crealf(_x[i]) + cimagf(_x[i])*cimagf(_x[i]);
+    }
+
+    *_e = e;
+    return cabsf(p) / (e + 1e-12f);
+}
+
+// update detection threshold after a false alarm (S1 time-out or invalid
+// SIGNAL field)
+void wlanframesync_false_alarm(wlanframesync _q)
+{
+    if (_q->pfa == 0.0f)
+        return;
+
+    _q->s0a_thresh += WLANFRAMESYNC_THRESH_STEP;
+    if (_q->s0a_thresh > WLANFRAMESYNC_S0A_ABS_THRESH_MAX)
+        _q->s0a_thresh = WLANFRAMESYNC_S0A_ABS_THRESH_MAX;
 }
 
 // compute S0 metrics
@@ -905,26 +1550,30 @@ void wlanframesync_estimate_gain_S1(wlanframesync _q,
                                     float complex * _x,
                                     float complex * _G)
 {
-    // move input array into fft input buffer
-    memmove(_q->x, _x, 64*sizeof(float complex));
-
     // compute fft, storing result into _q->X
-    FFT_EXECUTE(_q->fft);
+    wlanframesync_fft(_q, _x);
     
-    // nominal gain (normalization factor)
-    float gain = 0.11267f; // sqrt(52)/64 ; sqrtf(_q->M_S1) / (float)(_q->M);
+    // compute gain, multiplying by the (real) reference gain table, which
+    // is zero on NULL subcarriers
+    unsigned int i;
+    for (i=0; i<64; i++)
+        _G[i] = crealf(_q->X[i])*wlanframesync_S1c[i] + cimagf(_q->X[i])*wlanframesync_S1c[i]*_Complex_I;
+}
 
-    // compute gain, ignoring NULL subcarriers
+// compute normalized cross-correlation of input against long sequence,
+// |sum(x[i] conj(s1[i]))|^2 / (|x|^2 |s1|^2), where |s1|^2 = 64
+//  _x      :   input array (time), [size: 64 x 1]
+float wlanframesync_S1_xcorr(float complex * _x)
+{
+    float complex c = 0.0f; // cross-correlation
+    float         e = 0.0f; // energy
     unsigned int i;
     for (i=0; i<64; i++) {
-        if (i == 0 || (i>26 && i<38) ) {
-            // NULL subcarrier
-            _G[i] = 0.0f;
-        } else {
-            // DATA/PILOT subcarrier (S1 enabled)
-            _G[i] = _q->X[i] * conjf(wlanframe_S1[i]) * gain;
-        }
+        c += _x[i] * conjf(wlanframe_s1[i]);
+        e += crealf(_x[i])*crealf(_x[i]) + cimagf(_x[i])*cimagf(_x[i]);
     }
+
+    return (crealf(c)*crealf(c) + cimagf(c)*cimagf(c)) / (64.0f*e + 1e-12f);
 }
 
 // compute S1 metrics
@@ -932,15 +1581,21 @@ void wlanframesync_S1_metrics(wlanframesync _q,
                               float complex * _G,
                               float complex * _s_hat)
 {
-    // compute detector output
-    float complex s_hat = 0.0f;
+    // compute detector output, sum(G[i+1] conj(G[i])), in real arithmetic;
+    // the wrap-around term is zero as subcarrier 0 is NULL
+    float sr = 0.0f;
+    float si = 0.0f;
 
     unsigned int i;
-    for (i=0; i<64; i++)
-        s_hat += _G[(i+1)%64]*conjf(_G[i]);
+    for (i=0; i<63; i++) {
+        float ar = crealf(_G[i+1]), ai = cimagf(_G[i+1]);
+        float br = crealf(_G[i  ]), bi = cimagf(_G[i  ]);
+        sr += ar*br + ai*bi;
+        si += ai*br - ar*bi;
+    }
 
     // set output values, normalizing by number of elements
-    *_s_hat = s_hat * 0.019231f;    // 1/52
+    *_s_hat = (sr + si*_Complex_I) * 0.019231f;    // 1/52
 }
 
 // estimate carrier frequency offset from S1 gains
@@ -968,108 +1623,117 @@ void wlanframesync_estimate_eqgain(wlanframesync _q,
 {
 }
 
-// estimate complex equalizer gain from G0 and G1 using polynomial fit
+// estimate complex equalizer gain from G0 and G1 using polynomial fit;
+// the subcarrier frequencies are fixed, so the least-squares fit is a
+// product with a precomputed pseudo-inverse (see src/gentab)
 void wlanframesync_estimate_eqgain_poly(wlanframesync _q)
 {
     // polynomial order
-    unsigned int order = 2;
+    unsigned int order = WLANFRAMESYNC_EQGAIN_ORDER;
+    const float * P = wlan_eqfit_gentab[order];
 
-    // equalizer (polynomial)
-    float x_eq[52];             // frequency array
-    float y_eq_abs[52];         // magnitude array
-    float y_eq_arg[52];         // phase array
-    float p_eq_abs[order+1];    // polynomial coefficients (magnitude)
-    float p_eq_arg[order+1];    // polynomial coefficients (phase)
+    // polynomial coefficients
+    float p_eq_abs[4] = {0.0f, 0.0f, 0.0f, 0.0f};   // magnitude
+    float p_eq_arg[4] = {0.0f, 0.0f, 0.0f, 0.0f};   // phase
 
-    // average complex gains
+    // accumulate fit over subcarriers in ascending frequency order
+    // (effective fftshift), skipping NULL subcarriers
     unsigned int i;
+    unsigned int j;
     unsigned int k;
     unsigned int n=0;
+    float arg_prev    = 0.0f;   // previous (wrapped) phase
+    float arg_offset  = 0.0f;   // phase unwrapping offset
     for (i=0; i<64; i++) {
-        // start at mid-point (effective fftshift)
         k = (i + 32) % 64;
 
-        if (k == 0 || (k>26 && k<38) ) {
-            // NULL subcarrier
-        } else {
-            // validate counter
-            assert(n < 52);
-
-            // DATA/PILOT subcarrier (S1 enabled)
-            //float complex G = 0.5f*(_q->G1a + _q->G1b);
-            float complex G = _q->G1b[k];
-
-            // store resulting...
-            x_eq[n] = (k > 31) ? (float)k - (float)(64) : (float)k;
-            x_eq[n] = x_eq[n] / (float)(64);
-            y_eq_abs[n] = cabsf(G);
-            y_eq_arg[n] = cargf(G);
+        if (k == 0 || (k>26 && k<38) )
+            continue;
+
+        // DATA/PILOT subcarrier (S1 enabled), removing the phase slope
+        // due to the transform window leading the long sequence
+        float complex G = _q->G1b[k];
+        float y_abs = cabsf(G);
+        float y_arg = cargf(G) + 2.0f*M_PI*_q->s1_lead*((float)i - 32.0f)/64.0f;
+        while (y_arg >  M_PI) y_arg -= 2*M_PI;
+        while (y_arg < -M_PI) y_arg += 2*M_PI;
+
+        // unwrap phase: wrapped phases differ by less than 2*pi, so a
+        // single correction of the running offset suffices
+        if (n > 0) {
+            if      (y_arg - arg_prev >  M_PI) arg_offset -= 2*M_PI;
+            else if (y_arg - arg_prev < -M_PI) arg_offset += 2*M_PI;
+        }
+        arg_prev = y_arg;
+        y_arg += arg_offset;
 
-            // update counter
-            n++;
+        // p = P y
+        for (j=0; j<=order; j++) {
+            p_eq_abs[j] += P[52*j+n] * y_abs;
+            p_eq_arg[j] += P[52*j+n] * y_arg;
         }
-    }
-    
-    // validate counter
-    assert(n == 52);
 
-    // try to unwrap phase
-    for (i=1; i<52; i++) {
-        while ((y_eq_arg[i] - y_eq_arg[i-1]) >  M_PI)
-            y_eq_arg[i] -= 2*M_PI;
-        while ((y_eq_arg[i] - y_eq_arg[i-1]) < -M_PI)
-            y_eq_arg[i] += 2*M_PI;
+        // update counter
+        n++;
     }
 
-    // fit to polynomial(s)
-    polyf_fit(x_eq, y_eq_abs, 52, p_eq_abs, order+1);
-    polyf_fit(x_eq, y_eq_arg, 52, p_eq_arg, order+1);
+    // validate counter
+    assert(n == 52);
 
     // compute subcarrier gain
     for (i=0; i<64; i++) {
         
         if (i == 0 || (i>26 && i<38) ) {
             // NULL subcarrier
-            _q->G[i] = 0.0f;
-            _q->R[i] = 0.0f;
+            _q->G[i]    = 0.0f;
+            _q->R_re[i] = 0.0f;
+            _q->R_im[i] = 0.0f;
         } else {
             // DATA/PILOT subcarrier (S1 enabled)
             float freq = (i > 31) ? (float)i - (float)(64) : (float)i;
             freq = freq / (float)(64);
-            float A     = polyf_val(p_eq_abs, order+1, freq);
-            float theta = polyf_val(p_eq_arg, order+1, freq);
+
+            // evaluate polynomials (Horner's method), restoring the
+            // phase slope of the transform window
+            float A     = p_eq_abs[order];
+            float theta = p_eq_arg[order];
+            for (j=order; j>0; j--) {
+                A     = A    *freq + p_eq_abs[j-1];
+                theta = theta*freq + p_eq_arg[j-1];
+            }
+            theta -= 2.0f*M_PI*_q->s1_lead*freq;
+            float complex v = cosf(theta) + _Complex_I*sinf(theta);
 
             // composite channel estimation
-            _q->G[i] = A * cexpf(_Complex_I*theta);
+            _q->G[i] = A * v;
 
             // composite channel correction
             // 0.11267 = sqrt(52)/64
-            _q->R[i] = 0.11267f / (A + 1e-12f) * cexpf(-_Complex_I*theta);
+            float r = 0.11267f / (A + 1e-12f);
+            _q->R_re[i] =  r * crealf(v);
+            _q->R_im[i] = -r * cimagf(v);
         }
     }
-
 }
 
 // recover symbol, correcting for gain, pilot phase, etc.
 void wlanframesync_rxsymbol(wlanframesync _q)
 {
-    // apply gain
-    unsigned int i;
-    for (i=0; i<64; i++)
-        _q->X[i] *= _q->R[i];
-
-    // polynomial curve-fit
-    float x_phase[4] = {-21.0f, -7.0f, 7.0f, 21.0f};
-    float y_phase[4];
-    float p_phase[2];
-
     // update pilot phase
-    unsigned int pilot_phase = wlan_lfsr_advance(_q->ms_pilot);
+    unsigned int pilot_phase = wlan_lfsr_advance(&_q->ms_pilot);
 
-    y_phase[0] = pilot_phase ? cargf(-_q->X[43]) : cargf( _q->X[43]);
-    y_phase[1] = pilot_phase ? cargf(-_q->X[57]) : cargf( _q->X[57]);
-    y_phase[2] = pilot_phase ? cargf(-_q->X[ 7]) : cargf( _q->X[ 7]);
-    y_phase[3] = pilot_phase ? cargf( _q->X[21]) : cargf(-_q->X[21]);
+    // apply gain to pilot subcarriers only; the remaining subcarriers are
+    // corrected below along with the phase
+    float complex X43 = _q->X[43] * (_q->R_re[43] + _q->R_im[43]*_Complex_I);
+    float complex X57 = _q->X[57] * (_q->R_re[57] + _q->R_im[57]*_Complex_I);
+    float complex X07 = _q->X[ 7] * (_q->R_re[ 7] + _q->R_im[ 7]*_Complex_I);
+    float complex X21 = _q->X[21] * (_q->R_re[21] + _q->R_im[21]*_Complex_I);
+
+    float y_phase[4];
+    y_phase[0] = pilot_phase ? cargf(-X43) : cargf( X43);
+    y_phase[1] = pilot_phase ? cargf(-X57) : cargf( X57);
+    y_phase[2] = pilot_phase ? cargf(-X07) : cargf( X07);
+    y_phase[3] = pilot_phase ? cargf( X21) : cargf(-X21);
 
     // unwrap phase
     if ( (y_phase[1]-y_phase[0]) >  M_PI ) y_phase[1] -= 2*M_PI;
@@ -1085,16 +1749,21 @@ void wlanframesync_rxsymbol(wlanframesync _q)
     printf("    x = [-21 -7 7 21]; y = [%6.3f %6.3f %6.3f %6.3f];\n", y_phase[0], y_phase[1], y_phase[2], y_phase[3]);
 #endif
 
-    // fit phase to 1st-order polynomial (2 coefficients)
-    polyf_fit(x_phase, y_phase, 4, p_phase, 2);
+    // fit phase to 1st-order polynomial (2 coefficients); the pilot
+    // subcarriers x = {-21,-7,7,21} are fixed and symmetric, so the least-
+    // squares fit reduces to p0 = mean(y), p1 = sum(x*y) / sum(x^2) where
+    // sum(x^2) = 980
+    float p_phase[2];
+    p_phase[0] = 0.25f*(y_phase[0] + y_phase[1] + y_phase[2] + y_phase[3]);
+    p_phase[1] = (21.0f*(y_phase[3] - y_phase[0]) +
+                   7.0f*(y_phase[2] - y_phase[1])) / 980.0f;
 
-    // compensate for phase offset
-    // TODO : find more computationally efficient way to do this
-    for (i=0; i<64; i++) {
-        float fx    = (i > 31) ? (float)i - (float)(64) : (float)i;
-        float theta = polyf_val(p_phase, 2, fx);
-        _q->X[i] *= cexpf(-_Complex_I*theta);
-    }
+    // apply gain and compensate for phase offset p0 + p1*f where the
+    // subcarrier frequency index f is i on [0,31] and i-64 on [32,63]
+    wlanframesync_derotate_gain(&_q->X[ 0], &_q->R_re[ 0], &_q->R_im[ 0], 32,
+                                p_phase[0], p_phase[1], &_q->X[ 0]);
+    wlanframesync_derotate_gain(&_q->X[32], &_q->R_re[32], &_q->R_im[32], 32,
+                                p_phase[0] - 32.0f*p_phase[1], p_phase[1], &_q->X[32]);
 
     // adjust NCO frequency based on differential phase
     if (_q->num_symbols > 0) {
@@ -1104,7 +1773,7 @@ void wlanframesync_rxsymbol(wlanframesync _q)
         if (dphi_prime < -M_PI) dphi_prime += M_2_PI;
 
         // adjust NCO proportionally to phase error
-        nco_crcf_adjust_frequency(_q->nco_rx, 1e-3f*dphi_prime);
+        _q->nco_freq += 1e-3f*dphi_prime;
     }
     // set internal phase state
     _q->phi_prime = p_phase[0];
@@ -1137,6 +1806,12 @@ void wlanframesync_decode_signal(wlanframesync _q)
         return;
     }
 
+    // reject frames longer than the message buffers can hold
+    if (_q->length > _q->max_length) {
+        _q->signal_valid = 0;
+        return;
+    }
+
     // compute frame parameters
     _q->ndbps  = wlanframe_ratetab[_q->rate].ndbps; // number of data bits per OFDM symbol
     _q->ncbps  = wlanframe_ratetab[_q->rate].ncbps; // number of coded bits per OFDM symbol
@@ -1153,24 +1828,20 @@ void wlanframesync_decode_signal(wlanframesync _q)
     _q->npad = _q->ndata - (16 + 8*_q->length + 6);
 
     // compute decoded message length (number of data bytes)
-    // NOTE : because ndbps is _always_ divisible by 8, so must ndata be
-    _q->dec_msg_len = _q->ndata / 8;
+    // NOTE : ndbps is 36 for the 9 Mbps rate, so the last byte of the
+    //        DATA field is only partially used for an odd number of symbols
+    _q->dec_msg_len = (_q->ndata + 7) / 8;
 
-    // re-allocate buffer for decoded message
-    _q->msg_dec = (unsigned char*) realloc(_q->msg_dec, _q->dec_msg_len*sizeof(unsigned char));
+    // compute number of encoded data bytes per OFDM symbol
+    // (ncbps is always divisible by 8)
+    _q->bytes_per_symbol = _q->ncbps / 8;
 
     // compute encoded message length (number of data bytes)
-    _q->enc_msg_len = (_q->dec_msg_len * _q->ncbps) / _q->ndbps;
-
-    // compute number of encoded data bytes per OFDM symbol
-    _q->bytes_per_symbol = _q->enc_msg_len / _q->nsym;
+    _q->enc_msg_len = _q->nsym * _q->bytes_per_symbol;
 
     // validate encoded message length
     //assert(_q->enc_msg_len == wlan_packet_compute_enc_msg_len(_q->rate, _q->length));
 
-    // re-allocate buffer for encoded message
-    _q->msg_enc = (unsigned char*) realloc(_q->msg_enc, _q->enc_msg_len*sizeof(unsigned char));
-
     // re-create modem object
     _q->mod_scheme = wlanframe_ratetab[_q->rate].mod_scheme;
 
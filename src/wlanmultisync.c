@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2011 Joseph Gaeddert
+ * Copyright (c) 2011 Virginia Polytechnic Institute & State University
+ *
+ * This file is part of liquid.
+ *
+ * liquid is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * liquid is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with liquid.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+// wlanmultisync.c
+//
+// Multi-channel receiver: one frame synchronizer per channel, fed from
+// per-channel single-producer/single-consumer sample queues and run on
+// a pool of worker threads. A channel with queued samples is scheduled
+// onto exactly one worker's run queue at a time; idle workers steal
+// channels from the others.
+//
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include "liquid-wlan.internal.h"
+
+#define DEBUG_WLANMULTISYNC           0
+
+// maximum number of samples a worker processes on a channel before
+// re-queueing it, so that busy channels cannot starve the others
+#define WLANMULTISYNC_QUANTUM         (4096)
+
+// channel; producer- and consumer-side counters are kept on separate
+// cache lines
+struct wlanmultisync_channel_s {
+    // producer side
+    unsigned long int queue_write;      // total samples written (producer)
+    unsigned long int num_overflows;    // samples rejected: queue full
+    unsigned int max_backlog;           // backlog high-water mark
+
+    // consumer side
+    unsigned long int queue_read __attribute__((aligned(64))); // total samples read
+    unsigned long int num_frames;       // number of frames with valid header
+    wlanframesync fs;                   // frame synchronizer (in pool)
+    float complex * queue;              // sample queue [size: queue_len x 1]
+    unsigned int id;                    // channel id
+    wlanmultisync q;                    // parent object
+
+    // scheduling: set while the channel is on a run queue or being
+    // processed, so that it is never run by two workers at once
+    int scheduled;
+};
+
+// worker run queue (circular, holds each channel at most once)
+struct wlanmultisync_worker_s {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    unsigned int * ids;                 // channel ids [size: num_channels x 1]
+    unsigned int head;                  // index of oldest entry
+    unsigned int count;                 // number of entries
+    unsigned int index;                 // worker index
+    wlanmultisync q;                    // parent object
+};
+
+struct wlanmultisync_s {
+    unsigned int num_channels;          // number of channels
+    unsigned int num_workers;           // number of worker threads
+    unsigned int queue_len;             // per-channel queue length (power of 2)
+
+    struct wlanmultisync_channel_s * channels;
+    struct wlanmultisync_worker_s  * workers;
+    wlan_pool pool;                     // synchronizer memory
+
+    // user callback
+    wlanmultisync_callback callback;
+    void * userdata;
+
+    // worker sleep/wake-up and completion
+    pthread_mutex_t lock;
+    pthread_cond_t  work;               // signalled when a channel is queued
+    pthread_cond_t  idle;               // signalled when no channel is scheduled
+    unsigned int num_queued;            // channels on run queues (atomic)
+    unsigned int num_scheduled;         // channels scheduled (atomic)
+    int stop;                           // stop workers
+};
+
+// internal methods
+static int   wlanmultisync_sync_callback(int                    _header_valid,
+                                         unsigned char *        _payload,
+                                         struct wlan_rxvector_s _rxvector,
+                                         void *                 _userdata);
+static void * wlanmultisync_worker_run(void * _worker);
+static void  wlanmultisync_enqueue(wlanmultisync _q, unsigned int _worker, unsigned int _id);
+static int   wlanmultisync_dequeue(wlanmultisync _q, unsigned int _worker, unsigned int * _id);
+static void  wlanmultisync_process(wlanmultisync _q, unsigned int _worker, unsigned int _id);
+
+// create multi-channel receiver object
+//  _num_channels   :   number of channels
+//  _num_workers    :   number of worker threads
+//  _queue_len      :   per-channel sample queue length (rounded up to
+//                      power of 2)
+//  _callback       :   user-defined callback function
+//  _userdata       :   user-defined data structure
+wlanmultisync wlanmultisync_create(unsigned int           _num_channels,
+                                   unsigned int           _num_workers,
+                                   unsigned int           _queue_len,
+                                   wlanmultisync_callback _callback,
+                                   void *                 _userdata)
+{
+    // validate input
+    if (_num_channels == 0) {
+        fprintf(stderr,"error: wlanmultisync_create(), number of channels must be greater than zero\n");
+        exit(1);
+    } else if (_num_workers == 0) {
+        fprintf(stderr,"error: wlanmultisync_create(), number of workers must be greater than zero\n");
+        exit(1);
+    } else if (_queue_len < 80) {
+        fprintf(stderr,"error: wlanmultisync_create(), queue must hold at least one symbol\n");
+        exit(1);
+    }
+
+    wlanmultisync q = (wlanmultisync) malloc(sizeof(struct wlanmultisync_s));
+    q->num_channels = _num_channels;
+    q->num_workers  = _num_workers;
+    q->callback     = _callback;
+    q->userdata     = _userdata;
+
+    // round queue length up to power of 2 so that indices wrap with a mask
+    q->queue_len = 1;
+    while (q->queue_len < _queue_len)
+        q->queue_len <<= 1;
+
+    // create channels, placing synchronizers contiguously in a pool
+    q->pool = wlan_pool_create(wlanframesync_sizeof(), q->num_channels);
+    if (posix_memalign((void**)&q->channels, WLAN_MEMORY_ALIGN,
+                       q->num_channels*sizeof(struct wlanmultisync_channel_s)) != 0)
+    {
+        fprintf(stderr,"error: wlanmultisync_create(), could not allocate memory\n");
+        exit(1);
+    }
+    memset(q->channels, 0x00, q->num_channels*sizeof(struct wlanmultisync_channel_s));
+    unsigned int i;
+    for (i=0; i<q->num_channels; i++) {
+        struct wlanmultisync_channel_s * c = &q->channels[i];
+        c->id = i;
+        c->q  = q;
+        c->fs = wlanframesync_init(wlan_pool_alloc(q->pool), wlanmultisync_sync_callback, c);
+        if (posix_memalign((void**)&c->queue, WLAN_MEMORY_ALIGN, q->queue_len*sizeof(float complex)) != 0) {
+            fprintf(stderr,"error: wlanmultisync_create(), could not allocate memory\n");
+            exit(1);
+        }
+    }
+
+    // scheduling state
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->work, NULL);
+    pthread_cond_init(&q->idle, NULL);
+    q->num_queued    = 0;
+    q->num_scheduled = 0;
+    q->stop          = 0;
+
+    // create workers
+    q->workers = (struct wlanmultisync_worker_s*) malloc(q->num_workers*sizeof(struct wlanmultisync_worker_s));
+    for (i=0; i<q->num_workers; i++) {
+        struct wlanmultisync_worker_s * w = &q->workers[i];
+        pthread_mutex_init(&w->lock, NULL);
+        w->ids   = (unsigned int*) malloc(q->num_channels*sizeof(unsigned int));
+        w->head  = 0;
+        w->count = 0;
+        w->index = i;
+        w->q     = q;
+    }
+    for (i=0; i<q->num_workers; i++) {
+        if (pthread_create(&q->workers[i].thread, NULL, wlanmultisync_worker_run, &q->workers[i]) != 0) {
+            fprintf(stderr,"error: wlanmultisync_create(), could not create worker thread\n");
+            exit(1);
+        }
+    }
+
+    return q;
+}
+
+// destroy multi-channel receiver object; queued samples not yet
+// processed are discarded (see wlanmultisync_wait())
+void wlanmultisync_destroy(wlanmultisync _q)
+{
+    // stop and join workers
+    pthread_mutex_lock(&_q->lock);
+    __atomic_store_n(&_q->stop, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&_q->work);
+    pthread_mutex_unlock(&_q->lock);
+
+    // (all workers must have stopped before any run queue is destroyed,
+    // as idle workers steal from the others)
+    unsigned int i;
+    for (i=0; i<_q->num_workers; i++)
+        pthread_join(_q->workers[i].thread, NULL);
+    for (i=0; i<_q->num_workers; i++) {
+        pthread_mutex_destroy(&_q->workers[i].lock);
+        free(_q->workers[i].ids);
+    }
+    free(_q->workers);
+
+    // destroy channels
+    for (i=0; i<_q->num_channels; i++) {
+        wlanframesync_fini(_q->channels[i].fs);
+        wlan_pool_free(_q->pool, _q->channels[i].fs);
+        free(_q->channels[i].queue);
+    }
+    free(_q->channels);
+    wlan_pool_destroy(_q->pool);
+
+    pthread_mutex_destroy(&_q->lock);
+    pthread_cond_destroy(&_q->work);
+    pthread_cond_destroy(&_q->idle);
+    free(_q);
+}
+
+// print multi-channel receiver object internals
+void wlanmultisync_print(wlanmultisync _q)
+{
+    printf("wlanmultisync: %u channels, %u workers, queue length %u\n",
+            _q->num_channels, _q->num_workers, _q->queue_len);
+    unsigned int i;
+    for (i=0; i<_q->num_channels; i++) {
+        printf("    channel %3u : frames %6lu, backlog %7u (max %7u), overflows %lu\n",
+                i,
+                wlanmultisync_get_num_frames(_q, i),
+                wlanmultisync_get_backlog(_q, i),
+                wlanmultisync_get_max_backlog(_q, i),
+                wlanmultisync_get_num_overflows(_q, i));
+    }
+}
+
+// pin worker threads to cores (worker i to core i modulo the number of
+// online cores), returning '1' if not supported on this platform
+int wlanmultisync_pin_workers(wlanmultisync _q)
+{
+#if HAVE_PTHREAD_SETAFFINITY_NP
+    long int num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores < 1)
+        return 1;
+
+    unsigned int i;
+    int rc = 0;
+    for (i=0; i<_q->num_workers; i++) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(i % num_cores, &cpuset);
+        if (pthread_setaffinity_np(_q->workers[i].thread, sizeof(cpu_set_t), &cpuset) != 0)
+            rc = 1;
+    }
+    return rc;
+#else
+    return 1;
+#endif
+}
+
+// (producer) push samples onto channel queue, returning the number of
+// samples accepted; samples not accepted (queue full) are counted as
+// overflows and not queued. Each channel must have a single producer.
+//  _q          :   multi-channel receiver object
+//  _channel    :   channel id
+//  _buffer     :   input samples [size: _n x 1]
+//  _n          :   number of samples
+unsigned int wlanmultisync_push(wlanmultisync          _q,
+                                unsigned int           _channel,
+                                liquid_float_complex * _buffer,
+                                unsigned int           _n)
+{
+    // validate input
+    if (_channel >= _q->num_channels) {
+        fprintf(stderr,"error: wlanmultisync_push(), invalid channel\n");
+        exit(1);
+    }
+    struct wlanmultisync_channel_s * c = &_q->channels[_channel];
+
+    unsigned long int w = c->queue_write;
+    unsigned long int r = __atomic_load_n(&c->queue_read, __ATOMIC_ACQUIRE);
+    unsigned int mask = _q->queue_len - 1;
+
+    // accept as many samples as fit
+    unsigned int n = _q->queue_len - (unsigned int)(w - r);
+    if (n > _n) n = _n;
+    c->num_overflows += _n - n;
+
+    // copy in (at most) two contiguous pieces
+    unsigned int n0 = _q->queue_len - (unsigned int)(w & mask);
+    if (n0 > n) n0 = n;
+    memmove(&c->queue[w & mask], _buffer,      n0*sizeof(float complex));
+    memmove(c->queue,            &_buffer[n0], (n-n0)*sizeof(float complex));
+
+    // track backlog high-water mark
+    unsigned int backlog = (unsigned int)(w + n - r);
+    if (backlog > c->max_backlog)
+        c->max_backlog = backlog;
+
+    // publish samples, then schedule channel unless already scheduled;
+    // sequentially consistent so that a worker un-scheduling the channel
+    // either sees these samples or leaves the channel to be scheduled here
+    __atomic_store_n(&c->queue_write, w + n, __ATOMIC_SEQ_CST);
+    if (n > 0 && !__atomic_exchange_n(&c->scheduled, 1, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&_q->num_scheduled, 1, __ATOMIC_SEQ_CST);
+        wlanmultisync_enqueue(_q, _channel % _q->num_workers, _channel);
+    }
+
+    return n;
+}
+
+// wait until all samples pushed so far have been processed
+void wlanmultisync_wait(wlanmultisync _q)
+{
+    pthread_mutex_lock(&_q->lock);
+    while (__atomic_load_n(&_q->num_scheduled, __ATOMIC_SEQ_CST) > 0)
+        pthread_cond_wait(&_q->idle, &_q->lock);
+    pthread_mutex_unlock(&_q->lock);
+}
+
+// get number of channels
+unsigned int wlanmultisync_get_num_channels(wlanmultisync _q)
+{
+    return _q->num_channels;
+}
+
+// get number of samples queued on channel, not yet processed
+unsigned int wlanmultisync_get_backlog(wlanmultisync _q,
+                                       unsigned int  _channel)
+{
+    struct wlanmultisync_channel_s * c = &_q->channels[_channel];
+    unsigned long int w = __atomic_load_n(&c->queue_write, __ATOMIC_ACQUIRE);
+    unsigned long int r = __atomic_load_n(&c->queue_read,  __ATOMIC_ACQUIRE);
+    return (unsigned int)(w - r);
+}
+
+// get channel backlog high-water mark (samples)
+unsigned int wlanmultisync_get_max_backlog(wlanmultisync _q,
+                                           unsigned int  _channel)
+{
+    return _q->channels[_channel].max_backlog;
+}
+
+// get number of samples rejected by wlanmultisync_push() on channel
+unsigned long int wlanmultisync_get_num_overflows(wlanmultisync _q,
+                                                  unsigned int  _channel)
+{
+    return _q->channels[_channel].num_overflows;
+}
+
+// get number of frames with a valid header received on channel
+unsigned long int wlanmultisync_get_num_frames(wlanmultisync _q,
+                                               unsigned int  _channel)
+{
+    return __atomic_load_n(&_q->channels[_channel].num_frames, __ATOMIC_RELAXED);
+}
+
+//
+// internal methods
+//
+
+// synchronizer callback: forward to user callback with channel id
+static int wlanmultisync_sync_callback(int                    _header_valid,
+                                       unsigned char *        _payload,
+                                       struct wlan_rxvector_s _rxvector,
+                                       void *                 _userdata)
+{
+    struct wlanmultisync_channel_s * c = (struct wlanmultisync_channel_s*) _userdata;
+    if (_header_valid)
+        __atomic_add_fetch(&c->num_frames, 1, __ATOMIC_RELAXED);
+
+    wlanmultisync q = c->q;
+    if (q->callback == NULL)
+        return 0;
+    return q->callback(c->id, _header_valid, _payload, _rxvector, q->userdata);
+}
+
+// worker thread: run scheduled channels until stopped
+static void * wlanmultisync_worker_run(void * _worker)
+{
+    struct wlanmultisync_worker_s * w = (struct wlanmultisync_worker_s*) _worker;
+    wlanmultisync q = w->q;
+
+    unsigned int id;
+    while (!__atomic_load_n(&q->stop, __ATOMIC_ACQUIRE)) {
+        if (wlanmultisync_dequeue(q, w->index, &id)) {
+            wlanmultisync_process(q, w->index, id);
+            continue;
+        }
+
+        // sleep until a channel is queued
+        pthread_mutex_lock(&q->lock);
+        while (!q->stop && __atomic_load_n(&q->num_queued, __ATOMIC_SEQ_CST) == 0)
+            pthread_cond_wait(&q->work, &q->lock);
+        pthread_mutex_unlock(&q->lock);
+    }
+    return NULL;
+}
+
+// push channel onto worker's run queue and wake a worker
+static void wlanmultisync_enqueue(wlanmultisync _q,
+                                  unsigned int  _worker,
+                                  unsigned int  _id)
+{
+    struct wlanmultisync_worker_s * w = &_q->workers[_worker];
+    pthread_mutex_lock(&w->lock);
+    w->ids[(w->head + w->count) % _q->num_channels] = _id;
+    w->count++;
+    pthread_mutex_unlock(&w->lock);
+
+    __atomic_add_fetch(&_q->num_queued, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&_q->lock);
+    pthread_cond_signal(&_q->work);
+    pthread_mutex_unlock(&_q->lock);
+}
+
+// pop channel from worker's own run queue (oldest first, so channels are
+// served round-robin), otherwise steal the newest channel queued on
+// another worker; returns '1' if a channel was found
+static int wlanmultisync_dequeue(wlanmultisync  _q,
+                                 unsigned int   _worker,
+                                 unsigned int * _id)
+{
+    unsigned int i;
+    for (i=0; i<_q->num_workers; i++) {
+        struct wlanmultisync_worker_s * w = &_q->workers[(_worker + i) % _q->num_workers];
+        int found = 0;
+        pthread_mutex_lock(&w->lock);
+        if (w->count > 0) {
+            if (i == 0) {
+                *_id = w->ids[w->head];
+                w->head = (w->head + 1) % _q->num_channels;
+            } else {
+                *_id = w->ids[(w->head + w->count - 1) % _q->num_channels];
+            }
+            w->count--;
+            found = 1;
+        }
+        pthread_mutex_unlock(&w->lock);
+
+        if (found) {
+            __atomic_sub_fetch(&_q->num_queued, 1, __ATOMIC_SEQ_CST);
+#if DEBUG_WLANMULTISYNC
+            if (i > 0)
+                printf("wlanmultisync: worker %u stole channel %u\n", _worker, *_id);
+#endif
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// run channel synchronizer on (at most one quantum of) queued samples,
+// then re-queue the channel on this worker or un-schedule it
+static void wlanmultisync_process(wlanmultisync _q,
+                                  unsigned int  _worker,
+                                  unsigned int  _id)
+{
+    struct wlanmultisync_channel_s * c = &_q->channels[_id];
+
+    unsigned long int w = __atomic_load_n(&c->queue_write, __ATOMIC_ACQUIRE);
+    unsigned long int r = c->queue_read;
+    unsigned int mask = _q->queue_len - 1;
+
+    unsigned int n = (unsigned int)(w - r);
+    if (n > WLANMULTISYNC_QUANTUM) n = WLANMULTISYNC_QUANTUM;
+
+    // run synchronizer directly on queue, in (at most) two pieces
+    unsigned int n0 = _q->queue_len - (unsigned int)(r & mask);
+    if (n0 > n) n0 = n;
+    wlanframesync_execute(c->fs, &c->queue[r & mask], n0);
+    wlanframesync_execute(c->fs, c->queue,            n-n0);
+
+    // release space to producer
+    __atomic_store_n(&c->queue_read, r + n, __ATOMIC_RELEASE);
+
+    // more samples queued: keep channel on this worker (its state is
+    // still in this core's cache)
+    if (wlanmultisync_get_backlog(_q, _id) > 0) {
+        wlanmultisync_enqueue(_q, _worker, _id);
+        return;
+    }
+
+    // un-schedule channel, then re-check for samples pushed meanwhile
+    // (the producer only schedules the channel if it sees it cleared)
+    __atomic_store_n(&c->scheduled, 0, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&c->queue_write, __ATOMIC_SEQ_CST) != r + n &&
+        !__atomic_exchange_n(&c->scheduled, 1, __ATOMIC_SEQ_CST))
+    {
+        wlanmultisync_enqueue(_q, _worker, _id);
+        return;
+    }
+
+    // signal completion once no channel is scheduled
+    if (__atomic_sub_fetch(&_q->num_scheduled, 1, __ATOMIC_SEQ_CST) == 0) {
+        pthread_mutex_lock(&_q->lock);
+        pthread_cond_broadcast(&_q->idle);
+        pthread_mutex_unlock(&_q->lock);
+    }
+}